@@ -0,0 +1,180 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "EndlessMazeGenerator.h"
+#include "MazeGrid.h"
+#include "MazeTransformTable.h"
+#include "MazeGeneration.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/Pawn.h"
+#include "Kismet/KismetMathLibrary.h"
+
+// Sets default values
+AEndlessMazeGenerator::AEndlessMazeGenerator()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	FloorTileISMC = CreateDefaultSubobject<class UInstancedStaticMeshComponent>(TEXT("Floor InstancedStaticMesh"));
+	FloorTileISMC->SetMobility(EComponentMobility::Static);
+	FloorTileISMC->SetCollisionProfileName("BlockAll");
+
+	InnerWallTileISMC = CreateDefaultSubobject<class UInstancedStaticMeshComponent>(TEXT("Inner Wall InstancedStaticMesh"));
+	InnerWallTileISMC->SetMobility(EComponentMobility::Static);
+	InnerWallTileISMC->SetCollisionProfileName("BlockAll");
+
+	OuterWallTileISMC = CreateDefaultSubobject<class UInstancedStaticMeshComponent>(TEXT("Outer Wall InstancedStaticMesh"));
+	OuterWallTileISMC->SetMobility(EComponentMobility::Static);
+	OuterWallTileISMC->SetCollisionProfileName("BlockAll");
+}
+
+// Called when the game starts or when spawned
+void AEndlessMazeGenerator::BeginPlay()
+{
+	Super::BeginPlay();
+
+	SpawnRows();
+}
+
+void AEndlessMazeGenerator::SpawnRows()
+{
+	//Every loaded row owns a fixed range of instances, the outer walls end with the wall behind the oldest row
+	FloorTileISMC->ClearInstances();
+	InnerWallTileISMC->ClearInstances();
+	OuterWallTileISMC->ClearInstances();
+
+	TArray<FTransform> placeholderTransforms{};
+	placeholderTransforms.Init(FTransform::Identity, NrOfLoadedRows * NrOfMazeColumns);
+	FloorTileISMC->AddInstances(placeholderTransforms, false);
+	placeholderTransforms.Init(FTransform::Identity, NrOfLoadedRows * NrOfMazeColumns * FMazeGrid::NrOfWallPlanes);
+	InnerWallTileISMC->AddInstances(placeholderTransforms, false);
+	placeholderTransforms.Init(FTransform::Identity, NrOfLoadedRows * 2 + NrOfMazeColumns);
+	OuterWallTileISMC->AddInstances(placeholderTransforms, false);
+
+	EllersRow.Init(NrOfMazeColumns, MazeSeed);
+	NextRow = 0;
+	for (int row = 0; row < NrOfLoadedRows; row++)
+	{
+		CarveNextRow();
+	}
+	UpdateBackWalls();
+
+	FloorTileISMC->MarkRenderStateDirty();
+	InnerWallTileISMC->MarkRenderStateDirty();
+	OuterWallTileISMC->MarkRenderStateDirty();
+}
+
+void AEndlessMazeGenerator::CarveNextRow()
+{
+	SCOPE_CYCLE_COUNTER(STAT_MazeCarveRow);
+	TRACE_CPUPROFILER_EVENT_SCOPE(AEndlessMazeGenerator::CarveNextRow);
+
+	//The maze never ends, so no row closes the remaining sets
+	EllersRow.GenerateRow(false, EastWalls, SouthWalls);
+
+	const FQuat eastWallRotation = UKismetMathLibrary::FindLookAtRotation({ 1,0,0 }, { 0,0,0 }).Quaternion();
+	const FQuat southWallRotation = UKismetMathLibrary::FindLookAtRotation({ 0,-1,0 }, { 0,0,0 }).Quaternion();
+	const float rowY = MazeStartPosition.Y - NextRow * MazeTileSize - MazeTileSize / 2;
+
+	FloorTransforms.SetNumUninitialized(NrOfMazeColumns);
+	InnerWallTransforms.SetNumUninitialized(NrOfMazeColumns * FMazeGrid::NrOfWallPlanes);
+	for (int col = 0; col < NrOfMazeColumns; col++)
+	{
+		const FVector cellPosition{ MazeStartPosition.X + col * MazeTileSize - MazeTileSize / 2, rowY, MazeStartPosition.Z };
+		FloorTransforms[col] = FTransform(cellPosition);
+
+		//The last column has no east wall, its slot stays hidden
+		FTransform& eastWallTransform = InnerWallTransforms[col * FMazeGrid::NrOfWallPlanes + FMazeGrid::East];
+		eastWallTransform = FTransform(eastWallRotation, cellPosition + FVector(MazeTileSize / 2, 0, 0));
+		if (!((EastWalls[col >> 6] >> (col & 63)) & 1))
+			FMazeTransformTable::HideWall(eastWallTransform, MazeTileSize);
+
+		FTransform& southWallTransform = InnerWallTransforms[col * FMazeGrid::NrOfWallPlanes + FMazeGrid::South];
+		southWallTransform = FTransform(southWallRotation, cellPosition - FVector(0, MazeTileSize / 2, 0));
+		if (!((SouthWalls[col >> 6] >> (col & 63)) & 1))
+			FMazeTransformTable::HideWall(southWallTransform, MazeTileSize);
+	}
+
+	OuterWallTransforms.SetNumUninitialized(2);
+	OuterWallTransforms[0] = FTransform(eastWallRotation, { MazeStartPosition.X - MazeTileSize, rowY, 0 });
+	OuterWallTransforms[1] = FTransform(eastWallRotation, { MazeStartPosition.X + MazeTileSize * NrOfMazeColumns - MazeTileSize, rowY, 0 });
+
+	//Reuse the instances of the oldest row
+	const int rowSlot = NextRow % NrOfLoadedRows;
+	FloorTileISMC->BatchUpdateInstancesTransforms(rowSlot * FloorTransforms.Num(), FloorTransforms, true, false, true);
+	InnerWallTileISMC->BatchUpdateInstancesTransforms(rowSlot * InnerWallTransforms.Num(), InnerWallTransforms, true, false, true);
+	OuterWallTileISMC->BatchUpdateInstancesTransforms(rowSlot * OuterWallTransforms.Num(), OuterWallTransforms, true, false, true);
+	INC_DWORD_STAT_BY(STAT_MazeInstancesTouched, FloorTransforms.Num() + InnerWallTransforms.Num() + OuterWallTransforms.Num());
+	NextRow++;
+}
+
+void AEndlessMazeGenerator::UpdateBackWalls()
+{
+	//Close the maze behind the oldest loaded row
+	const FQuat backWallRotation = UKismetMathLibrary::FindLookAtRotation({ 0,1,0 }, { 0,0,0 }).Quaternion();
+	const int oldestRow = FMath::Max(NextRow - NrOfLoadedRows, 0);
+	const float wallY = MazeStartPosition.Y - oldestRow * MazeTileSize;
+
+	OuterWallTransforms.SetNumUninitialized(NrOfMazeColumns);
+	for (int col = 0; col < NrOfMazeColumns; col++)
+	{
+		OuterWallTransforms[col] = FTransform(backWallRotation, { MazeStartPosition.X + col * MazeTileSize - MazeTileSize / 2, wallY, 0 });
+	}
+	OuterWallTileISMC->BatchUpdateInstancesTransforms(NrOfLoadedRows * 2, OuterWallTransforms, true, false, true);
+}
+
+int AEndlessMazeGenerator::GetFurthestPlayerRow() const
+{
+	int furthestRow = INDEX_NONE;
+	FVector viewLocation{};
+	FRotator viewRotation{};
+	for (FConstPlayerControllerIterator it = GetWorld()->GetPlayerControllerIterator(); it; ++it)
+	{
+		APlayerController* playerController = it->Get();
+		if (!playerController)
+			continue;
+
+		if (playerController->IsLocalController())
+		{
+			playerController->GetPlayerViewPoint(viewLocation, viewRotation);
+		}
+		else if (HasAuthority() && playerController->GetPawn())
+		{
+			//The server carves ahead of remote players too, otherwise they run into rows without collision
+			viewLocation = playerController->GetPawn()->GetActorLocation();
+		}
+		else
+		{
+			continue;
+		}
+		furthestRow = FMath::Max(furthestRow, FMath::FloorToInt((MazeStartPosition.Y - viewLocation.Y) / MazeTileSize));
+	}
+	return furthestRow;
+}
+
+// Called every frame
+void AEndlessMazeGenerator::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const int furthestPlayerRow = GetFurthestPlayerRow();
+	if (furthestPlayerRow == INDEX_NONE)
+		return;
+
+	//Rows ahead of the players are carved a few per frame, so the cost of a frame doesn't depend on how fast the players move
+	const int lastRow = furthestPlayerRow + FMath::Min(NrOfRowsAhead, NrOfLoadedRows - 1);
+	int nrOfCarvedRows = 0;
+	while (NextRow <= lastRow && nrOfCarvedRows < MaxRowsPerFrame)
+	{
+		CarveNextRow();
+		nrOfCarvedRows++;
+	}
+
+	if (nrOfCarvedRows > 0)
+	{
+		UpdateBackWalls();
+		FloorTileISMC->MarkRenderStateDirty();
+		InnerWallTileISMC->MarkRenderStateDirty();
+		OuterWallTileISMC->MarkRenderStateDirty();
+	}
+}
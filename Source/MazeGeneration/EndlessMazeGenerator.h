@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "MazeEllersRow.h"
+#include "EndlessMazeGenerator.generated.h"
+
+/**
+ * A maze that keeps extending ahead of the players, carved one row at a time with Eller's algorithm.
+ * Only a fixed amount of rows exist at the same time, the instances of the oldest row are reused for the next row.
+ */
+UCLASS()
+class MAZEGENERATION_API AEndlessMazeGenerator : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this actor's properties
+	AEndlessMazeGenerator();
+
+	/*The start point of the maze, the rows continue along the negative Y-axis.*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze settings")
+		FVector MazeStartPosition = {};
+
+	/*The amount of columns in the maze (width).*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze settings", meta = (ClampMin = "1"))
+		int NrOfMazeColumns = 10;
+
+	/*The amount of rows that exist at the same time.*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze settings", meta = (ClampMin = "2"))
+		int NrOfLoadedRows = 40;
+
+	/*How many rows are carved ahead of the furthest local player, at most the amount of loaded rows minus one.*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze settings", meta = (ClampMin = "1"))
+		int NrOfRowsAhead = 20;
+
+	/*The maximum amount of rows carved in one frame.*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze settings", meta = (ClampMin = "1"))
+		int MaxRowsPerFrame = 2;
+
+	/*The seed of the maze, the same seed carves the same rows.*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze settings")
+		int32 MazeSeed = 0;
+
+	/*The size of the maze tiles (Floors & Walls).*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze settings")
+		float MazeTileSize = 600;
+
+	UPROPERTY(VisibleAnywhere, Category = "Meshes")
+		UInstancedStaticMeshComponent* FloorTileISMC;
+	UPROPERTY(VisibleAnywhere, Category = "Meshes")
+		UInstancedStaticMeshComponent* InnerWallTileISMC;
+	UPROPERTY(VisibleAnywhere, Category = "Meshes")
+		UInstancedStaticMeshComponent* OuterWallTileISMC;
+
+protected:
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+
+private:
+	FMazeEllersRow EllersRow;
+	int NextRow = 0;
+
+	//Scratch of the row that is carved
+	TArray<uint64> EastWalls;
+	TArray<uint64> SouthWalls;
+	TArray<FTransform> FloorTransforms;
+	TArray<FTransform> InnerWallTransforms;
+	TArray<FTransform> OuterWallTransforms;
+
+	void SpawnRows();
+	void CarveNextRow();
+	void UpdateBackWalls();
+	int GetFurthestPlayerRow() const;
+
+public:
+	// Called every frame
+	virtual void Tick(float DeltaTime) override;
+
+};
@@ -0,0 +1,239 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MazeBenchmarkCommandlet.h"
+#include "MazeGenerator.h"
+#include "MazeGrid.h"
+#include "MazeChunkGrid.h"
+#include "MazeWallDiff.h"
+#include "MazeTopologyGrid.h"
+#include "Private/MazeGenerationTask.h"
+#include "Private/MazeGenerationScratch.h"
+#include "Private/MazeAllocationCounter.h"
+#include "Private/MazeTopologyKernels.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeExit.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogMazeBenchmark, Log, All);
+
+namespace
+{
+	const int DefaultMazeSizes[] = { 25, 50, 100, 250, 500, 1000, 2000, 4096 };
+	const int DefaultParallelTileSizes[] = { 0, 256 };
+
+	/*Parses a comma separated list of numbers, the default values are used if the parameter isn't there.*/
+	TArray<int> ParseIntList(const FString& params, const TCHAR* name, const TArray<int>& defaultValues)
+	{
+		FString valueString{};
+		if (!FParse::Value(*params, name, valueString))
+			return defaultValues;
+
+		TArray<FString> valueStrings{};
+		valueString.ParseIntoArray(valueStrings, TEXT(","));
+		TArray<int> values{};
+		for (const FString& value : valueStrings)
+		{
+			values.Add(FCString::Atoi(*value));
+		}
+		return values;
+	}
+
+	double GetMedian(TArray<double>& values)
+	{
+		values.Sort();
+		return values.Num() > 0 ? values[values.Num() / 2] : 0.0;
+	}
+
+	/*Times the depth-first search or Kruskal's kernel of a topology, the median of the repeats after a warm up.*/
+	template<typename TTopology>
+	void BenchmarkTopology(EMazeAlgorithm algorithm, int mazeSize, int nrOfLayers, int repeats, int32 seed, TArray<double>& outGenerateTimes, int64& outNrOfCells)
+	{
+		TMazeTopologyGrid<TTopology> mazeGrid{};
+		TArray<int> cells{};
+		FMazeDisjointSet cellSets{};
+		for (int repeat = 0; repeat <= repeats; repeat++)
+		{
+			FRandomStream randomStream((int32)HashCombine(GetTypeHash(seed), GetTypeHash(repeat)));
+			mazeGrid.Init(mazeSize, mazeSize, nrOfLayers);
+			const double generateStart = FPlatformTime::Seconds();
+			if (algorithm == EMazeAlgorithm::RANDOMKRUSKALS)
+				TMazeTopologyKernels<TMazeTopologyGrid<TTopology>>::Kruskals(mazeGrid, randomStream, cells, cellSets);
+			else
+				TMazeTopologyKernels<TMazeTopologyGrid<TTopology>>::DepthFirst(mazeGrid, randomStream, cells);
+			const double generateTime = FPlatformTime::Seconds() - generateStart;
+
+			if (repeat > 0)
+				outGenerateTimes.Add(generateTime);
+		}
+		outNrOfCells = mazeGrid.GetNrOfCells();
+	}
+
+	//Kept alive for the whole run, blocks allocated through it can be freed after it is uninstalled
+	FMazeAllocationCounter AllocationCounter;
+}
+
+UMazeBenchmarkCommandlet::UMazeBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UMazeBenchmarkCommandlet::Main(const FString& Params)
+{
+	const UEnum* algorithmEnum = StaticEnum<EMazeAlgorithm>();
+	TArray<int> allAlgorithms{};
+	for (int enumIdx = 0; enumIdx < algorithmEnum->NumEnums() - 1; enumIdx++)
+	{
+		allAlgorithms.Add((int)algorithmEnum->GetValueByIndex(enumIdx));
+	}
+
+	const TArray<int> algorithms = ParseIntList(Params, TEXT("algorithms="), allAlgorithms);
+	const TArray<int> mazeSizes = ParseIntList(Params, TEXT("sizes="), TArray<int>(DefaultMazeSizes, UE_ARRAY_COUNT(DefaultMazeSizes)));
+	const TArray<int> parallelTileSizes = ParseIntList(Params, TEXT("tilesizes="), TArray<int>(DefaultParallelTileSizes, UE_ARRAY_COUNT(DefaultParallelTileSizes)));
+	const TArray<int> topologies = ParseIntList(Params, TEXT("topologies="), TArray<int>());
+	int nrOfLayers = 4;
+	FParse::Value(*Params, TEXT("layers="), nrOfLayers);
+	nrOfLayers = FMath::Max(nrOfLayers, 1);
+
+	//Installed once for the whole run, the repeats only turn the counting on and off
+	AllocationCounter.Install();
+	ON_SCOPE_EXIT
+	{
+		AllocationCounter.Uninstall();
+	};
+
+	int repeats = 3;
+	FParse::Value(*Params, TEXT("repeats="), repeats);
+	repeats = FMath::Max(repeats, 1);
+	int32 seed = 1;
+	FParse::Value(*Params, TEXT("seed="), seed);
+
+	FString outputPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Benchmarks"),
+		FString::Printf(TEXT("MazeBenchmark-%s.csv"), *FDateTime::Now().ToString()));
+	FParse::Value(*Params, TEXT("output="), outputPath);
+
+	FString csv = TEXT("Algorithm,Columns,Rows,Cells,ParallelTileSize,Repeats,GenerateMs,MinGenerateMs,NsPerCell,Allocations,EpochAllocations,PeakMemoryMB,DiffMs,ChangedWalls,TransformsMs\n");
+
+	FMazeGrid mazes[2]{};
+	FMazeWallDiff wallDiff{};
+	FMazeChunkGrid chunkGrid{};
+	for (int algorithm : algorithms)
+	{
+		const FString algorithmName = algorithmEnum->GetNameStringByValue(algorithm);
+		for (int parallelTileSize : parallelTileSizes)
+		{
+			for (int mazeSize : mazeSizes)
+			{
+				FMazeGenerationSettings settings{};
+				settings.Algorithm = (EMazeAlgorithm)algorithm;
+				settings.ParallelTileSize = parallelTileSize;
+
+				//Every repeat generates the next epoch, the diff compares it with the maze of the previous repeat
+				TArray<double> generateTimes{};
+				TArray<double> diffTimes{};
+				int64 nrOfAllocations = 0;
+				int64 nrOfEpochAllocations = 0;
+				int64 peakBytes = 0;
+				FMazeGenerationScratch scratch{};
+				for (int repeat = 0; repeat <= repeats; repeat++)
+				{
+					FMazeGrid& newMaze = mazes[repeat % 2];
+					FMazeGrid& oldMaze = mazes[(repeat + 1) % 2];
+					settings.Seed = (int32)HashCombine(GetTypeHash(seed), GetTypeHash(repeat));
+
+					//Counts the whole epoch like the maze generator does it: resetting the back buffer, generating and comparing
+					AllocationCounter.Reset();
+					AllocationCounter.StartCounting();
+					newMaze.Init(FVector::ZeroVector, mazeSize, mazeSize, 100.f);
+					const double generateStart = FPlatformTime::Seconds();
+					FMazeGenerationTask::Generate(settings, newMaze, scratch);
+					const double generateTime = FPlatformTime::Seconds() - generateStart;
+					const double diffStart = FPlatformTime::Seconds();
+					wallDiff.Compute(oldMaze.Walls, newMaze.Walls);
+					const double diffTime = FPlatformTime::Seconds() - diffStart;
+					AllocationCounter.StopCounting();
+					peakBytes = FMath::Max(peakBytes, AllocationCounter.GetPeakBytes());
+
+					//The first repeat sizes the buffers and warms up the caches, the diff has no maze to compare with
+					if (repeat == 0)
+					{
+						nrOfAllocations = AllocationCounter.GetNrOfAllocations();
+						continue;
+					}
+
+					generateTimes.Add(generateTime);
+					diffTimes.Add(diffTime);
+					nrOfEpochAllocations = FMath::Max(nrOfEpochAllocations, AllocationCounter.GetNrOfAllocations());
+				}
+
+				//The transforms are built chunk by chunk like the streaming does, so big mazes don't need all of them at once
+				const FMazeGrid& lastMaze = mazes[repeats % 2];
+				chunkGrid.Build(lastMaze, 32);
+				const double transformsStart = FPlatformTime::Seconds();
+				for (FMazeChunk& chunk : chunkGrid.Chunks)
+				{
+					chunk.TransformTable.Build(lastMaze, chunk.Cells);
+					chunk.TransformTable.Empty();
+				}
+				const double transformsTime = FPlatformTime::Seconds() - transformsStart;
+
+				const int64 nrOfCells = (int64)mazeSize * mazeSize;
+				const double minGenerateTime = FMath::Min(generateTimes);
+				const double generateTime = GetMedian(generateTimes);
+				const double diffTime = GetMedian(diffTimes);
+				const double nsPerCell = generateTime * 1e9 / nrOfCells;
+				csv += FString::Printf(TEXT("%s,%d,%d,%lld,%d,%d,%.3f,%.3f,%.2f,%lld,%lld,%.2f,%.3f,%d,%.3f\n"),
+					*algorithmName, mazeSize, mazeSize, nrOfCells, parallelTileSize, repeats,
+					generateTime * 1000, minGenerateTime * 1000, nsPerCell, nrOfAllocations, nrOfEpochAllocations, peakBytes / (1024.0 * 1024.0),
+					diffTime * 1000, wallDiff.GetNrOfChangedWalls(), transformsTime * 1000);
+
+				UE_LOG(LogMazeBenchmark, Display, TEXT("%s %dx%d tiles %d: %.3f ms (%.2f ns/cell), %lld allocations (%lld per epoch), %.2f MB peak, diff %.3f ms"),
+					*algorithmName, mazeSize, mazeSize, parallelTileSize, generateTime * 1000, nsPerCell, nrOfAllocations, nrOfEpochAllocations,
+					peakBytes / (1024.0 * 1024.0), diffTime * 1000);
+			}
+		}
+	}
+
+	//Only the generation is timed, the other columns are for square mazes
+	for (int topology : topologies)
+	{
+		if (topology != (int)EMazeTopology::Hex && topology != (int)EMazeTopology::Layered)
+			continue;
+
+		const TCHAR* topologyName = topology == (int)EMazeTopology::Hex ? TEXT("Hex") : TEXT("Layered");
+		for (EMazeAlgorithm algorithm : { EMazeAlgorithm::RANDOMDEPTHFIRSTSEARCH, EMazeAlgorithm::RANDOMKRUSKALS })
+		{
+			const FString algorithmName = FString::Printf(TEXT("%s %s"), *algorithmEnum->GetNameStringByValue((int64)algorithm), topologyName);
+			for (int mazeSize : mazeSizes)
+			{
+				TArray<double> generateTimes{};
+				int64 nrOfCells = 0;
+				if (topology == (int)EMazeTopology::Hex)
+					BenchmarkTopology<FMazeHexTopology>(algorithm, mazeSize, 1, repeats, seed, generateTimes, nrOfCells);
+				else
+					BenchmarkTopology<FMazeLayeredTopology>(algorithm, mazeSize, nrOfLayers, repeats, seed, generateTimes, nrOfCells);
+
+				const double minGenerateTime = FMath::Min(generateTimes);
+				const double generateTime = GetMedian(generateTimes);
+				const double nsPerCell = nrOfCells > 0 ? generateTime * 1e9 / nrOfCells : 0;
+				csv += FString::Printf(TEXT("%s,%d,%d,%lld,0,%d,%.3f,%.3f,%.2f,0,0,0,0,0,0\n"),
+					*algorithmName, mazeSize, mazeSize, nrOfCells, repeats, generateTime * 1000, minGenerateTime * 1000, nsPerCell);
+
+				UE_LOG(LogMazeBenchmark, Display, TEXT("%s %dx%d (%lld cells): %.3f ms (%.2f ns/cell)"),
+					*algorithmName, mazeSize, mazeSize, nrOfCells, generateTime * 1000, nsPerCell);
+			}
+		}
+	}
+
+	if (!FFileHelper::SaveStringToFile(csv, *outputPath))
+	{
+		UE_LOG(LogMazeBenchmark, Error, TEXT("Could not write %s"), *outputPath);
+		return 1;
+	}
+
+	UE_LOG(LogMazeBenchmark, Display, TEXT("Wrote %s"), *outputPath);
+	return 0;
+}
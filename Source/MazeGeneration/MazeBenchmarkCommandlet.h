@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MazeBenchmarkCommandlet.generated.h"
+
+/**
+ * Generates mazes of every algorithm over a range of sizes and writes the timings to Saved/Benchmarks as csv.
+ * Hex (1) and layered (2) topologies only run depth-first search and Kruskal's, on the sizes times the amount of layers.
+ * UE4Editor-Cmd MazeGeneration.uproject -run=MazeBenchmark -nullrhi -unattended
+ *   [-sizes=25,100,4096] [-algorithms=0,2] [-tilesizes=0,256] [-topologies=1,2] [-layers=4] [-repeats=3] [-seed=1] [-output=path.csv]
+ */
+UCLASS()
+class MAZEGENERATION_API UMazeBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UMazeBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,73 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MazeChunkGrid.h"
+
+FMazeChunkGrid::FMazeChunkGrid()
+	:MazeStartPosition()
+	, NrOfMazeColumns(-1)
+	, NrOfMazeRows(-1)
+	, MazeTileSize(0)
+	, ChunkSize(0)
+	, NrOfCellsPerChunk(1)
+	, NrOfChunkColumns(0)
+{
+}
+
+bool FMazeChunkGrid::Matches(const FMazeGrid& mazeGrid, int chunkSize) const
+{
+	return NrOfMazeColumns == mazeGrid.NrOfMazeColumns
+		&& NrOfMazeRows == mazeGrid.NrOfMazeRows
+		&& MazeTileSize == mazeGrid.MazeTileSize
+		&& MazeStartPosition == mazeGrid.MazeStartPosition
+		&& ChunkSize == chunkSize;
+}
+
+void FMazeChunkGrid::Build(const FMazeGrid& mazeGrid, int chunkSize)
+{
+	MazeStartPosition = mazeGrid.MazeStartPosition;
+	NrOfMazeColumns = mazeGrid.NrOfMazeColumns;
+	NrOfMazeRows = mazeGrid.NrOfMazeRows;
+	MazeTileSize = mazeGrid.MazeTileSize;
+	ChunkSize = chunkSize;
+
+	NrOfCellsPerChunk = chunkSize > 0 ? chunkSize : FMath::Max3(NrOfMazeColumns, NrOfMazeRows, 1);
+	NrOfChunkColumns = FMath::DivideAndRoundUp(NrOfMazeColumns, NrOfCellsPerChunk);
+	const int nrOfChunkRows = FMath::DivideAndRoundUp(NrOfMazeRows, NrOfCellsPerChunk);
+
+	Chunks.Reset();
+	Chunks.SetNum(NrOfChunkColumns * nrOfChunkRows);
+	for (int chunkIdx = 0; chunkIdx < Chunks.Num(); chunkIdx++)
+	{
+		FMazeChunk& chunk = Chunks[chunkIdx];
+		const int firstCol = (chunkIdx % NrOfChunkColumns) * NrOfCellsPerChunk;
+		const int firstRow = (chunkIdx / NrOfChunkColumns) * NrOfCellsPerChunk;
+		chunk.Cells = FIntRect(firstCol, firstRow,
+			FMath::Min(firstCol + NrOfCellsPerChunk, NrOfMazeColumns), FMath::Min(firstRow + NrOfCellsPerChunk, NrOfMazeRows));
+
+		//Cell centers are half a tile before the column and after the row, rows go down along the Y-axis
+		const FVector2D min{ MazeStartPosition.X + (chunk.Cells.Min.X - 1) * MazeTileSize, MazeStartPosition.Y - chunk.Cells.Max.Y * MazeTileSize };
+		const FVector2D max{ MazeStartPosition.X + (chunk.Cells.Max.X - 1) * MazeTileSize, MazeStartPosition.Y - chunk.Cells.Min.Y * MazeTileSize };
+		chunk.Bounds = FBox2D(min, max);
+	}
+}
+
+SIZE_T FMazeChunkGrid::GetAllocatedSize() const
+{
+	SIZE_T allocatedSize = Chunks.GetAllocatedSize();
+	for (const FMazeChunk& chunk : Chunks)
+	{
+		allocatedSize += chunk.TransformTable.GetAllocatedSize();
+	}
+	return allocatedSize;
+}
+
+float FMazeChunkGrid::GetSquaredDistance(int chunkIdx, const TArray<FVector>& locations) const
+{
+	float closestDistanceSquared = MAX_flt;
+	for (const FVector& location : locations)
+	{
+		closestDistanceSquared = FMath::Min(closestDistanceSquared, Chunks[chunkIdx].Bounds.ComputeSquaredDistanceToPoint(FVector2D(location)));
+	}
+	return closestDistanceSquared;
+}
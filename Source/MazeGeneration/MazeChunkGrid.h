@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MazeGrid.h"
+#include "MazeTransformTable.h"
+
+class UHierarchicalInstancedStaticMeshComponent;
+class UMazeWallCollisionComponent;
+
+/**
+ * A square of cells with its own instanced meshes, so wall changes and culling stay local to the chunk.
+ * A chunk owns the floors of its cells, the east and south walls of its cells and the outer walls along them.
+ * The components and transforms are only held while the chunk is loaded.
+ */
+struct FMazeChunk
+{
+	FIntRect Cells;
+	FBox2D Bounds;
+	FMazeTransformTable TransformTable;
+
+	UHierarchicalInstancedStaticMeshComponent* FloorISMC = nullptr;
+	UHierarchicalInstancedStaticMeshComponent* InnerWallISMC = nullptr;
+	UHierarchicalInstancedStaticMeshComponent* OuterWallISMC = nullptr;
+
+	//Only used when the inner walls collide as merged boxes, the boxes are rebuilt on a worker after the walls changed
+	UMazeWallCollisionComponent* InnerWallCollision = nullptr;
+	int CollisionBuildId = INDEX_NONE;
+	bool IsCollisionDirty = false;
+
+	FORCEINLINE bool IsLoaded() const { return InnerWallISMC != nullptr; }
+};
+
+/**
+ * Splits a maze into chunks of a fixed amount of cells.
+ * The chunks only depend on the dimensions of the maze and the chunk size, the walls are still generated for
+ * the whole maze so the borders between chunks are seamless.
+ */
+struct MAZEGENERATION_API FMazeChunkGrid
+{
+	FMazeChunkGrid();
+
+	bool Matches(const FMazeGrid& mazeGrid, int chunkSize) const;
+	/*Splits the maze in chunks of chunkSize by chunkSize cells, the whole maze is one chunk if chunkSize isn't positive.*/
+	void Build(const FMazeGrid& mazeGrid, int chunkSize);
+
+	FORCEINLINE int GetNrOfChunks() const { return Chunks.Num(); }
+	SIZE_T GetAllocatedSize() const;
+	FORCEINLINE int GetChunkIndex(int row, int col) const
+	{
+		return (row / NrOfCellsPerChunk) * NrOfChunkColumns + col / NrOfCellsPerChunk;
+	}
+
+	/*Squared distance in the XY-plane from the chunk to the closest location, MAX_flt if there are no locations.*/
+	float GetSquaredDistance(int chunkIdx, const TArray<FVector>& locations) const;
+
+	TArray<FMazeChunk> Chunks;
+
+private:
+	FVector MazeStartPosition;
+	int NrOfMazeColumns;
+	int NrOfMazeRows;
+	float MazeTileSize;
+	int ChunkSize;
+
+	int NrOfCellsPerChunk;
+	int NrOfChunkColumns;
+};
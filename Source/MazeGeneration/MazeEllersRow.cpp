@@ -0,0 +1,76 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MazeEllersRow.h"
+
+FMazeEllersRow::FMazeEllersRow()
+	:NrOfMazeColumns(0)
+	, NrOfWordsPerRow(0)
+{
+}
+
+void FMazeEllersRow::Init(int nrOfMazeColumns, int32 seed)
+{
+	RandomStream.Initialize(seed);
+	NrOfMazeColumns = FMath::Max(nrOfMazeColumns, 0);
+	NrOfWordsPerRow = (NrOfMazeColumns + 63) / 64;
+	Sets.Init(INDEX_NONE, NrOfMazeColumns);
+}
+
+void FMazeEllersRow::GenerateRow(bool isLastRow, TArray<uint64>& outEastWalls, TArray<uint64>& outSouthWalls)
+{
+	outEastWalls.Init(0, NrOfWordsPerRow);
+	outSouthWalls.Init(0, NrOfWordsPerRow);
+
+	//Cells that continue the same set from the row above are already connected, SetCounts holds the first column of every old set
+	RowSets.Init(NrOfMazeColumns);
+	SetCounts.Init(INDEX_NONE, NrOfMazeColumns);
+	for (int col = 0; col < NrOfMazeColumns; col++)
+	{
+		const int set = Sets[col];
+		if (set == INDEX_NONE)
+			continue;
+
+		if (SetCounts[set] == INDEX_NONE)
+			SetCounts[set] = col;
+		else
+			RowSets.Union(SetCounts[set], col);
+	}
+
+	//Join adjacent cells of different sets at random, the last row joins all of them
+	for (int col = 0; col + 1 < NrOfMazeColumns; col++)
+	{
+		const bool isJoined = (isLastRow || RandomStream.FRand() < 0.5f) && RowSets.Union(col, col + 1);
+		if (!isJoined)
+			outEastWalls[col >> 6] |= 1ull << (col & 63);
+	}
+
+	if (isLastRow)
+	{
+		Sets.Init(INDEX_NONE, NrOfMazeColumns);
+		return;
+	}
+
+	//Every set continues down at least once, the other cells drop down at random
+	SetCounts.Init(0, NrOfMazeColumns);
+	IsSetContinued.Init(false, NrOfMazeColumns);
+	for (int col = 0; col < NrOfMazeColumns; col++)
+	{
+		Sets[col] = RowSets.Find(col);
+		SetCounts[Sets[col]]++;
+	}
+
+	for (int col = 0; col < NrOfMazeColumns; col++)
+	{
+		const int set = Sets[col];
+		const bool isLastCellOfSet = --SetCounts[set] == 0;
+		if (RandomStream.FRand() < 0.5f || (isLastCellOfSet && !IsSetContinued[set]))
+		{
+			IsSetContinued[set] = true;
+			continue;
+		}
+
+		Sets[col] = INDEX_NONE;
+		outSouthWalls[col >> 6] |= 1ull << (col & 63);
+	}
+}
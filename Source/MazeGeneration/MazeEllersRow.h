@@ -0,0 +1,43 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Private/MazeDisjointSet.h"
+
+/**
+ * Eller's algorithm, carves a maze one row at a time.
+ * Only the set of every cell in the current row is kept, so the memory and the cost of a row only depend on the width.
+ */
+struct MAZEGENERATION_API FMazeEllersRow
+{
+	FMazeEllersRow();
+
+	/*Starts a new maze, the first row has no connections to a row above. The same seed carves the same rows.*/
+	void Init(int nrOfMazeColumns, int32 seed);
+
+	/**
+	 * Carves the next row, the walls are bits per column padded to whole words like a row of FMazeGrid.
+	 * The last row joins every set that is left so the maze is closed, it has no south walls.
+	 */
+	void GenerateRow(bool isLastRow, TArray<uint64>& outEastWalls, TArray<uint64>& outSouthWalls);
+
+	FORCEINLINE int GetNrOfWordsPerRow() const { return NrOfWordsPerRow; }
+	FORCEINLINE SIZE_T GetAllocatedSize() const
+	{
+		return Sets.GetAllocatedSize() + RowSets.GetAllocatedSize() + SetCounts.GetAllocatedSize() + IsSetContinued.GetAllocatedSize();
+	}
+
+private:
+	int NrOfMazeColumns;
+	int NrOfWordsPerRow;
+	FRandomStream RandomStream;
+
+	//Set of every cell in the current row, INDEX_NONE if the cell isn't connected to the row above
+	TArray<int> Sets;
+
+	//Scratch of the current row, the sets are relabeled to the column of their root every row
+	FMazeDisjointSet RowSets;
+	TArray<int> SetCounts;
+	TBitArray<> IsSetContinued;
+};
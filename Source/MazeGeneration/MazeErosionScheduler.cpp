@@ -0,0 +1,131 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MazeErosionScheduler.h"
+#include "MazeGrid.h"
+#include "MazeGeneration.h"
+#include "NiagaraFunctionLibrary.h"
+
+void FMazeErosionScheduler::Schedule(const FMazeGrid& mazeGrid, const TArray<int>& removedWalls, float maxDelay)
+{
+	//The cycle stat is counted in Append
+	TRACE_CPUPROFILER_EVENT_SCOPE(FMazeErosionScheduler::Schedule);
+
+	//Buckets keep their memory between changes
+	MazeStartPosition = mazeGrid.MazeStartPosition;
+	BucketSize = mazeGrid.MazeTileSize * NrOfCellsPerBucket;
+	NrOfBucketColumns = FMath::DivideAndRoundUp(FMath::Max(mazeGrid.NrOfMazeColumns, 1), NrOfCellsPerBucket);
+	NrOfBucketRows = FMath::DivideAndRoundUp(FMath::Max(mazeGrid.NrOfMazeRows, 1), NrOfCellsPerBucket);
+
+	//Walls of the previous maze that never got their fx are dropped
+	NrOfDroppedWalls += NrOfPendingWalls;
+	Buckets.SetNum(NrOfBucketColumns * NrOfBucketRows);
+	for (auto& bucket : Buckets)
+		bucket.Reset();
+	BucketVisitStamps.Init(VisitStamp, Buckets.Num());
+	NrOfPendingWalls = 0;
+
+	Append(mazeGrid, removedWalls, maxDelay);
+}
+
+void FMazeErosionScheduler::Append(const FMazeGrid& mazeGrid, const TArray<int>& removedWalls, float maxDelay)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MazeErosionSchedule);
+	TRACE_CPUPROFILER_EVENT_SCOPE(FMazeErosionScheduler::Append);
+
+	int fromCellIdx{}, toCellIdx{};
+	for (int wallIdx : removedWalls)
+	{
+		if (!mazeGrid.GetWallCells(wallIdx, fromCellIdx, toCellIdx))
+			continue;
+
+		const int bucketRow = (fromCellIdx / mazeGrid.NrOfMazeColumns) / NrOfCellsPerBucket;
+		const int bucketCol = (fromCellIdx % mazeGrid.NrOfMazeColumns) / NrOfCellsPerBucket;
+		//Same rotation as FindLookAtRotation from the wall direction to the origin
+		const float yaw = mazeGrid.GetWallPlane(wallIdx) == FMazeGrid::East ? 180.f : 90.f;
+		Buckets[bucketRow * NrOfBucketColumns + bucketCol].Add({ mazeGrid.GetWallPosition(wallIdx), yaw });
+	}
+
+	//The last walls get the full delay, a wavefront keeps the earlier walls waiting a bit longer
+	NrOfPendingWalls += removedWalls.Num();
+	ExpireTime = FPlatformTime::Seconds() + maxDelay;
+}
+
+void FMazeErosionScheduler::Update(UWorld* world, UNiagaraSystem* erosionFX, const TArray<FVector>& playerLocations, float radius, int maxSpawnsPerFrame, float frameBudgetMs)
+{
+	Stats.NrOfCulled = NrOfDroppedWalls;
+	Stats.NrOfDeferred = 0;
+	Stats.NrOfSpawned = 0;
+	NrOfDroppedWalls = 0;
+	if (NrOfPendingWalls == 0)
+		return;
+
+	SCOPE_CYCLE_COUNTER(STAT_MazeErosionUpdate);
+	TRACE_CPUPROFILER_EVENT_SCOPE(FMazeErosionScheduler::Update);
+
+	//Walls no player came close to in time are dropped
+	const double startTime = FPlatformTime::Seconds();
+	if (startTime >= ExpireTime || !world || !erosionFX || BucketSize <= 0)
+	{
+		Stats.NrOfCulled += NrOfPendingWalls;
+		for (auto& bucket : Buckets)
+			bucket.Reset();
+		NrOfPendingWalls = 0;
+		return;
+	}
+
+	const double endTime = startTime + frameBudgetMs / 1000.0;
+	const float radiusSquared = radius * radius;
+	VisitStamp++;
+
+	for (const FVector& playerLocation : playerLocations)
+	{
+		//Buckets overlapping the square around the player, the bucket grid starts one tile before the start position
+		const int minBucketCol = FMath::Max(FMath::FloorToInt((playerLocation.X - radius - MazeStartPosition.X) / BucketSize + 1.f / NrOfCellsPerBucket), 0);
+		const int maxBucketCol = FMath::Min(FMath::FloorToInt((playerLocation.X + radius - MazeStartPosition.X) / BucketSize + 1.f / NrOfCellsPerBucket), NrOfBucketColumns - 1);
+		const int minBucketRow = FMath::Max(FMath::FloorToInt((MazeStartPosition.Y - playerLocation.Y - radius) / BucketSize), 0);
+		const int maxBucketRow = FMath::Min(FMath::FloorToInt((MazeStartPosition.Y - playerLocation.Y + radius) / BucketSize), NrOfBucketRows - 1);
+
+		for (int bucketRow = minBucketRow; bucketRow <= maxBucketRow; bucketRow++)
+		{
+			for (int bucketCol = minBucketCol; bucketCol <= maxBucketCol; bucketCol++)
+			{
+				//Buckets in reach of multiple players are only visited once
+				const int bucketIdx = bucketRow * NrOfBucketColumns + bucketCol;
+				if (BucketVisitStamps[bucketIdx] == VisitStamp)
+					continue;
+				BucketVisitStamps[bucketIdx] = VisitStamp;
+
+				TArray<FPendingErosion>& bucket = Buckets[bucketIdx];
+				for (int idx = bucket.Num() - 1; idx >= 0; idx--)
+				{
+					if (FVector::DistSquared2D(bucket[idx].Location, playerLocation) > radiusSquared)
+						continue;
+
+					if (Stats.NrOfSpawned >= maxSpawnsPerFrame || FPlatformTime::Seconds() >= endTime)
+					{
+						Stats.NrOfDeferred++;
+						continue;
+					}
+
+					UNiagaraFunctionLibrary::SpawnSystemAtLocation(world, erosionFX, bucket[idx].Location,
+						FRotator(0.f, bucket[idx].Yaw, 0.f), FVector(1.f), false, true, ENCPoolMethod::AutoRelease);
+					bucket.RemoveAtSwap(idx, 1, false);
+					NrOfPendingWalls--;
+					Stats.NrOfSpawned++;
+					INC_DWORD_STAT(STAT_MazeFXSpawned);
+				}
+			}
+		}
+	}
+}
+
+SIZE_T FMazeErosionScheduler::GetAllocatedSize() const
+{
+	SIZE_T allocatedSize = Buckets.GetAllocatedSize() + BucketVisitStamps.GetAllocatedSize();
+	for (const auto& bucket : Buckets)
+	{
+		allocatedSize += bucket.GetAllocatedSize();
+	}
+	return allocatedSize;
+}
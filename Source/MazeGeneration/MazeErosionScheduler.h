@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MazeErosionScheduler.generated.h"
+
+struct FMazeGrid;
+class UNiagaraSystem;
+
+USTRUCT(BlueprintType)
+struct FMazeErosionStats
+{
+	GENERATED_BODY()
+
+	/*Walls that were dropped because no player came close enough in time.*/
+	UPROPERTY(BlueprintReadOnly, VisibleInstanceOnly, Category = "Maze FX")
+		int NrOfCulled = 0;
+
+	/*Walls near a player that have to wait for a next frame because the budget ran out.*/
+	UPROPERTY(BlueprintReadOnly, VisibleInstanceOnly, Category = "Maze FX")
+		int NrOfDeferred = 0;
+
+	UPROPERTY(BlueprintReadOnly, VisibleInstanceOnly, Category = "Maze FX")
+		int NrOfSpawned = 0;
+};
+
+/**
+ * Spreads the erosion fx of removed walls over multiple frames.
+ * Walls are bucketed in a coarse grid, so only the buckets around the local players are visited every frame.
+ * The Niagara components come from the world's component pool.
+ */
+class MAZEGENERATION_API FMazeErosionScheduler
+{
+public:
+	/*Replaces the walls waiting for fx with the removed walls of a new maze.*/
+	void Schedule(const FMazeGrid& mazeGrid, const TArray<int>& removedWalls, float maxDelay);
+	/*Adds removed walls to the walls waiting for fx, for a change that removes its walls over multiple frames.*/
+	void Append(const FMazeGrid& mazeGrid, const TArray<int>& removedWalls, float maxDelay);
+
+	/*Spawns the fx of walls within the radius of a player, until the spawn count or time budget runs out.*/
+	void Update(UWorld* world, UNiagaraSystem* erosionFX, const TArray<FVector>& playerLocations, float radius, int maxSpawnsPerFrame, float frameBudgetMs);
+
+	FORCEINLINE bool HasPendingWalls() const { return NrOfPendingWalls > 0; }
+	FORCEINLINE const FMazeErosionStats& GetStats() const { return Stats; }
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	struct FPendingErosion
+	{
+		FVector Location;
+		float Yaw;
+	};
+
+	static const int NrOfCellsPerBucket = 8;
+
+	TArray<TArray<FPendingErosion>> Buckets;
+	TArray<uint32> BucketVisitStamps;
+	uint32 VisitStamp = 0;
+	int NrOfPendingWalls = 0;
+	int NrOfDroppedWalls = 0;
+	double ExpireTime = 0;
+
+	FVector MazeStartPosition;
+	float BucketSize = 0;
+	int NrOfBucketColumns = 0;
+	int NrOfBucketRows = 0;
+
+	FMazeErosionStats Stats;
+};
@@ -4,3 +4,34 @@
 #include "Modules/ModuleManager.h"
 
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, MazeGeneration, "MazeGeneration" );
+
+DEFINE_STAT(STAT_MazeGridInit);
+DEFINE_STAT(STAT_MazeCarve);
+DEFINE_STAT(STAT_MazeCarveTiled);
+DEFINE_STAT(STAT_MazeStitchTiles);
+DEFINE_STAT(STAT_MazeCarveRow);
+DEFINE_STAT(STAT_MazeMutate);
+DEFINE_STAT(STAT_MazeHandoff);
+DEFINE_STAT(STAT_MazeChange);
+DEFINE_STAT(STAT_MazeWallDiff);
+DEFINE_STAT(STAT_MazeBuildTransforms);
+DEFINE_STAT(STAT_MazeSpawnInnerWalls);
+DEFINE_STAT(STAT_MazeUpdateInnerWalls);
+DEFINE_STAT(STAT_MazeLoadChunk);
+DEFINE_STAT(STAT_MazeChunkStreaming);
+DEFINE_STAT(STAT_MazeErosionSchedule);
+DEFINE_STAT(STAT_MazeErosionUpdate);
+DEFINE_STAT(STAT_MazeSolverUpdate);
+DEFINE_STAT(STAT_MazeFindPath);
+DEFINE_STAT(STAT_MazeBuildWallCollision);
+
+DEFINE_STAT(STAT_MazeWallsChanged);
+DEFINE_STAT(STAT_MazeMutationMoves);
+DEFINE_STAT(STAT_MazeInstancesTouched);
+DEFINE_STAT(STAT_MazeFXSpawned);
+DEFINE_STAT(STAT_MazeLoadedChunks);
+DEFINE_STAT(STAT_MazeReadyMazes);
+DEFINE_STAT(STAT_MazeGeneratingMazes);
+DEFINE_STAT(STAT_MazeChangeDelay);
+DEFINE_STAT(STAT_MazeGenerationLatency);
+DEFINE_STAT(STAT_MazeBytesHeld);
@@ -3,4 +3,39 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
 
+//Shown with "stat Maze", every cycle stat also has a trace cpu scope for Unreal Insights
+DECLARE_STATS_GROUP(TEXT("Maze"), STATGROUP_Maze, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Grid Init"), STAT_MazeGridInit, STATGROUP_Maze, MAZEGENERATION_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Carve"), STAT_MazeCarve, STATGROUP_Maze, MAZEGENERATION_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Carve Tiled"), STAT_MazeCarveTiled, STATGROUP_Maze, MAZEGENERATION_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Stitch Tiles"), STAT_MazeStitchTiles, STATGROUP_Maze, MAZEGENERATION_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Carve Row"), STAT_MazeCarveRow, STATGROUP_Maze, MAZEGENERATION_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Mutate"), STAT_MazeMutate, STATGROUP_Maze, MAZEGENERATION_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Handoff"), STAT_MazeHandoff, STATGROUP_Maze, MAZEGENERATION_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Change Maze"), STAT_MazeChange, STATGROUP_Maze, MAZEGENERATION_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Wall Diff"), STAT_MazeWallDiff, STATGROUP_Maze, MAZEGENERATION_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Build Transforms"), STAT_MazeBuildTransforms, STATGROUP_Maze, MAZEGENERATION_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Spawn Inner Walls"), STAT_MazeSpawnInnerWalls, STATGROUP_Maze, MAZEGENERATION_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update Inner Walls"), STAT_MazeUpdateInnerWalls, STATGROUP_Maze, MAZEGENERATION_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Load Chunk"), STAT_MazeLoadChunk, STATGROUP_Maze, MAZEGENERATION_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Chunk Streaming"), STAT_MazeChunkStreaming, STATGROUP_Maze, MAZEGENERATION_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Erosion Schedule"), STAT_MazeErosionSchedule, STATGROUP_Maze, MAZEGENERATION_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Erosion Update"), STAT_MazeErosionUpdate, STATGROUP_Maze, MAZEGENERATION_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Solver Update"), STAT_MazeSolverUpdate, STATGROUP_Maze, MAZEGENERATION_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Find Path"), STAT_MazeFindPath, STATGROUP_Maze, MAZEGENERATION_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Build Wall Collision"), STAT_MazeBuildWallCollision, STATGROUP_Maze, MAZEGENERATION_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Walls Changed"), STAT_MazeWallsChanged, STATGROUP_Maze, MAZEGENERATION_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Mutation Moves"), STAT_MazeMutationMoves, STATGROUP_Maze, MAZEGENERATION_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Instances Touched"), STAT_MazeInstancesTouched, STATGROUP_Maze, MAZEGENERATION_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Erosion FX Spawned"), STAT_MazeFXSpawned, STATGROUP_Maze, MAZEGENERATION_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Loaded Chunks"), STAT_MazeLoadedChunks, STATGROUP_Maze, MAZEGENERATION_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Ready Mazes"), STAT_MazeReadyMazes, STATGROUP_Maze, MAZEGENERATION_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Generating Mazes"), STAT_MazeGeneratingMazes, STATGROUP_Maze, MAZEGENERATION_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Change Delay (ms)"), STAT_MazeChangeDelay, STATGROUP_Maze, MAZEGENERATION_API);
+DECLARE_FLOAT_ACCUMULATOR_STAT_EXTERN(TEXT("Generation Latency (ms)"), STAT_MazeGenerationLatency, STATGROUP_Maze, MAZEGENERATION_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Bytes Held"), STAT_MazeBytesHeld, STATGROUP_Maze, MAZEGENERATION_API);
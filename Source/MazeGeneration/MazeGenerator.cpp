@@ -2,55 +2,132 @@
 
 
 #include "MazeGenerator.h"
-#include "RandomDepthFirstSearch.h"
-#include "Private\RandomKruskals.h"
-#include <Runtime\Core\Public\ProfilingDebugging\ABTesting.h>
-#include <Runtime\Engine\Public\DrawDebugHelpers.h>
-#include <Runtime\Engine\Classes\Kismet\KismetMathLibrary.h>
-#include <Niagara\Public\NiagaraFunctionLibrary.h>
-
-
+#include "MazeGeneration.h"
+#include "Private/MazeGenerationTask.h"
+#include "Private/MazeGenerationScratch.h"
+#include "Private/MazeGenerationRing.h"
+#include "MazeSolverSubsystem.h"
+#include "MazeWallComponent.h"
+#include "MazeWallCollision.h"
+#include "MazeWallCollisionComponent.h"
+#include "NavigationSystem.h"
+#include "Engine/StaticMesh.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "TimerManager.h"
+#include "Async/ParallelFor.h"
+#include "Async/Async.h"
+#include "ProfilingDebugging/ABTesting.h"
+#include "DrawDebugHelpers.h"
+#include "Kismet/KismetMathLibrary.h"
+#include "NiagaraFunctionLibrary.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/Pawn.h"
+#include "Net/UnrealNetwork.h"
+
+
+namespace
+{
+	/*Adds all instances in one call, the transforms are only converted when the component isn't at the origin.*/
+	void AddInstancesWorldSpace(UHierarchicalInstancedStaticMeshComponent* component, const TArray<FTransform>& worldTransforms)
+	{
+		INC_DWORD_STAT_BY(STAT_MazeInstancesTouched, worldTransforms.Num());
+		const FTransform componentTransform = component->GetComponentTransform();
+		if (componentTransform.Equals(FTransform::Identity))
+		{
+			component->AddInstances(worldTransforms, false);
+		}
+		else
+		{
+			TArray<FTransform> localTransforms{};
+			localTransforms.SetNumUninitialized(worldTransforms.Num());
+			ParallelFor(worldTransforms.Num(), [&](int idx)
+			{
+				localTransforms[idx] = worldTransforms[idx].GetRelativeTransform(componentTransform);
+			});
+			component->AddInstances(localTransforms, false);
+		}
 
+		//The cluster tree is built on a worker once all instances are in
+		component->BuildTreeIfOutdated(true, false);
+	}
+}
 
 // Sets default values
 AMazeGenerator::AMazeGenerator()
 {
-	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
+	// Maze changes are driven by a timer and generation completion, so ticking starts disabled.
 	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
 
-	FloorTileISMC = CreateDefaultSubobject<class UInstancedStaticMeshComponent>(TEXT("Floor InstancedStaticMesh"));
+	FloorTileISMC = CreateDefaultSubobject<class UHierarchicalInstancedStaticMeshComponent>(TEXT("Floor InstancedStaticMesh"));
 	FloorTileISMC->SetMobility(EComponentMobility::Static);
 	FloorTileISMC->SetCollisionProfileName("BlockAll");
 
-	InnerWallTileISMC = CreateDefaultSubobject<class UInstancedStaticMeshComponent>(TEXT("Inner Wall InstancedStaticMesh"));
+	InnerWallTileISMC = CreateDefaultSubobject<class UMazeWallComponent>(TEXT("Inner Wall InstancedStaticMesh"));
 	InnerWallTileISMC->SetMobility(EComponentMobility::Static);
 	InnerWallTileISMC->SetCollisionProfileName("BlockAll");
 
-	InnerWallTileISMC2 = CreateDefaultSubobject<class UInstancedStaticMeshComponent>(TEXT("Inner Wall 2 InstancedStaticMesh"));
-	InnerWallTileISMC2->SetMobility(EComponentMobility::Static);
-	InnerWallTileISMC2->SetCollisionProfileName("BlockAll");
-
-	OuterWallTileISMC = CreateDefaultSubobject<class UInstancedStaticMeshComponent>(TEXT("Outer Wall InstancedStaticMesh"));
+	OuterWallTileISMC = CreateDefaultSubobject<class UHierarchicalInstancedStaticMeshComponent>(TEXT("Outer Wall InstancedStaticMesh"));
 	OuterWallTileISMC->SetMobility(EComponentMobility::Static);
 	OuterWallTileISMC->SetCollisionProfileName("BlockAll");
 
-	ElapsedTimeUntilMazeChange = MazeChangeTimer;
+	//Instances are added and moved in batches, the cluster trees are only rebuilt after a batch
+	FloorTileISMC->bAutoRebuildTreeOnInstanceChanges = false;
+	InnerWallTileISMC->bAutoRebuildTreeOnInstanceChanges = false;
+	OuterWallTileISMC->bAutoRebuildTreeOnInstanceChanges = false;
+
+	//Only the seed and the epoch are replicated, clients generate the same mazes themselves
+	bReplicates = true;
+	bAlwaysRelevant = true;
+
+	FrontMaze = MakeShared<FMazeGrid, ESPMode::ThreadSafe>();
+	MazeRing = MakeShared<FMazeGenerationRing>();
+	GenerationScratch = MakeShared<FMazeGenerationScratch, ESPMode::ThreadSafe>();
 }
 
 void AMazeGenerator::GenerateMaze()
 {
+	//The server starts a new epoch, clients generate the epoch of the server
+	if (HasAuthority())
+	{
+		if (MazeSeed == 0)
+			MazeSeed = FMath::RandRange(1, MAX_int32);
+		if (FrontMazeEpoch != INDEX_NONE)
+			MazeEpoch++;
+	}
+	IsMazeChangeDue = false;
+
+	//Replaying the mutations since the last keyframe takes a while in a long session, so a worker catches up and the maze shows up when it's ready
+	if (MazeChangeMode == EMazeChangeMode::MUTATE && GetMutationKeyframe(MazeEpoch) != MazeEpoch)
+	{
+		MazeRing->Reset(NrOfPregeneratedMazes, MazeEpoch);
+		RequestNextMazes();
+		IsMazeChangeDue = true;
+		MazeChangeDueTime = FPlatformTime::Seconds();
+		UpdateMemoryStats();
+		return;
+	}
+
 	double Time = 0;
 	FDurationTimer DurationTimer = FDurationTimer(Time);
 	DurationTimer.Start();
 
-	if (MazeGenerationAlgorithm == EMazeAlgorithm::RANDOMDEPTHFIRSTSEARCH)
-		GenerateDFSMaze();
-	else if (MazeGenerationAlgorithm == EMazeAlgorithm::RANDOMKRUSKALS)
-		RandomKruskals randomKruskals(MazeStartPosition, NrOfMazeColumns, NrOfMazeRows, MazeTileSize, MazeNodeArray, WallList);
+	FrontMaze->Init(MazeStartPosition, NrOfMazeColumns, NrOfMazeRows, MazeTileSize);
+	FrontMazeEpoch = MazeEpoch;
+	FrontMazeSeed = GetEpochSeed(MazeEpoch);
+	FMazeGenerationTask::Run(GetGenerationSettings(FrontMazeEpoch, false), *FrontMaze, *GenerationScratch);
+
+	//A new maze is shown at once, a wavefront that was still running is dropped
+	ChangedWalls.Reset();
+	NrOfAppliedWalls = 0;
+	DisplayedMaze = *FrontMaze;
+	UpdateMazeSolver();
 
 	DurationTimer.Stop();
+	const int nrOfCells = NrOfMazeColumns * NrOfMazeRows;
+	const double cellsPerSecond = Time > 0 ? nrOfCells / Time : 0;
 	if (GEngine)
-		GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Blue, FString::SanitizeFloat(Time));
+		GEngine->AddOnScreenDebugMessage(-1, 2.f, FColor::Blue, FString::Printf(TEXT("Generated %d cells in %f s (%.0f cells/s)"), nrOfCells, Time, cellsPerSecond));
 
 	////Debugging
 	if (DrawDebug)
@@ -59,10 +136,29 @@ void AMazeGenerator::GenerateMaze()
 	//Spawn meshes
 	SpawnMeshes();
 
-	//Create next maze
-	if (MazeGenerationAlgorithm == EMazeAlgorithm::RANDOMDEPTHFIRSTSEARCH)
-		GenerateDFSMazeAsync();
+	//Create next mazes, the mazes generated ahead of the old maze are dropped
+	MazeRing->Reset(NrOfPregeneratedMazes, FrontMazeEpoch + 1);
+	RequestNextMazes();
+	StartMazeChangeTimer();
+	UpdateMemoryStats();
+}
+
+int32 AMazeGenerator::GetEpochSeed(int32 epoch) const
+{
+	return (int32)HashCombine(GetTypeHash(MazeSeed), GetTypeHash(epoch));
+}
+
+bool AMazeGenerator::LineTraceWalls(FVector start, FVector end, FVector& outHitLocation, FVector& outHitNormal) const
+{
+	return FrontMazeEpoch != INDEX_NONE && FMazeWallCollision::LineTrace(DisplayedMaze, start, end, outHitLocation, outHitNormal);
+}
+
+void AMazeGenerator::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
+	DOREPLIFETIME(AMazeGenerator, MazeSeed);
+	DOREPLIFETIME(AMazeGenerator, MazeEpoch);
 }
 
 // Called when the game starts or when spawned
@@ -72,210 +168,749 @@ void AMazeGenerator::BeginPlay()
 
 }
 
-void AMazeGenerator::SpawnMeshes(bool isSpawningFloors, bool isSpawningOuterWalls, bool IsSpawningInnerWalls)
+void AMazeGenerator::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	FTransform floorTransform{};
-	FTransform wallTransform{};
-	FRotator wallRotation{};
-	FVector wallDirection{};
-	FVector wallPos{ 0,0,0 };
+	GetWorldTimerManager().ClearTimer(MazeChangeTimerHandle);
+	GetWorldTimerManager().ClearTimer(ChunkStreamingTimerHandle);
+
+	//Workers that are still busy finish into slots nobody looks at anymore
+	MazeRing->Empty();
+	UpdateGenerationStats();
 
-	if (isSpawningOuterWalls)
-		SpawnOuterWalls(floorTransform, wallTransform, wallRotation, wallDirection, wallPos);
+	UWorld* world = GetWorld();
+	if (UMazeSolverSubsystem* mazeSolver = world ? world->GetSubsystem<UMazeSolverSubsystem>() : nullptr)
+		mazeSolver->RemoveMaze(this);
 
-	if (isSpawningFloors)
-		SpawnFloors(floorTransform);
+#if STATS
+	DEC_DWORD_STAT_BY(STAT_MazeLoadedChunks, NrOfReportedChunks);
+	DEC_MEMORY_STAT_BY(STAT_MazeBytesHeld, ReportedBytesHeld);
+	NrOfReportedChunks = 0;
+	ReportedBytesHeld = 0;
+#endif
 
-	if (IsSpawningInnerWalls)
-		SpawnInnerWalls(floorTransform, wallTransform, wallRotation, wallDirection, wallPos);
+	Super::EndPlay(EndPlayReason);
 }
 
-void AMazeGenerator::SpawnOuterWalls(FTransform& floorTransform, FTransform& wallTransform, FRotator& wallRotation, FVector& wallDirection, FVector& wallPos)
+void AMazeGenerator::SpawnMeshes()
 {
-	//outer walls along X-axis
-	wallRotation = UKismetMathLibrary::FindLookAtRotation({ 0,1,0 }, { 0,0,0 });
-	wallTransform.SetRotation(wallRotation.Quaternion());
-	for (size_t col = 0; col < NrOfMazeColumns; col++)
+	//The chunks only change with the maze dimensions, loaded chunks keep their components and transforms
+	if (!ChunkGrid.Matches(*FrontMaze, MazeChunkSize))
 	{
-		wallPos.X = MazeStartPosition.X + col * MazeTileSize - MazeTileSize / 2;
-		//Walls on the BOTTOM
-		wallPos.Y = MazeStartPosition.Y;
-		wallTransform.SetLocation(wallPos);
-		OuterWallTileISMC->AddInstanceWorldSpace(wallTransform);
-		//Walls on the TOP
-		wallPos.Y = MazeStartPosition.Y - NrOfMazeRows * MazeTileSize;
-		wallTransform.SetLocation(wallPos);
-		OuterWallTileISMC->AddInstanceWorldSpace(wallTransform);
+		UnloadChunks();
+		ChunkGrid.Build(*FrontMaze, MazeChunkSize);
 	}
-	//outer walls along Y-axis
-	wallRotation = UKismetMathLibrary::FindLookAtRotation({ 1,0,0 }, { 0,0,0 });
-	wallTransform.SetRotation(wallRotation.Quaternion());
-	for (size_t row = 0; row < NrOfMazeRows; row++)
+
+	for (FMazeChunk& chunk : ChunkGrid.Chunks)
 	{
-		wallPos.Y = MazeStartPosition.Y - row * MazeTileSize - MazeTileSize / 2;
-		//Walls on the LEFT
-		wallPos.X = MazeStartPosition.X - MazeTileSize;
-		wallTransform.SetLocation(wallPos);
-		OuterWallTileISMC->AddInstanceWorldSpace(wallTransform);
-		//Walls on the Right
-		wallPos.X = MazeStartPosition.X + MazeTileSize * NrOfMazeColumns - MazeTileSize;
-		wallTransform.SetLocation(wallPos);
-		OuterWallTileISMC->AddInstanceWorldSpace(wallTransform);
+		if (!chunk.IsLoaded())
+			continue;
+
+		chunk.FloorISMC->ClearInstances();
+		chunk.InnerWallISMC->ClearInstances();
+		chunk.OuterWallISMC->ClearInstances();
+		SpawnOuterWalls(chunk);
+		SpawnFloors(chunk);
+		SpawnInnerWalls(chunk);
+		chunk.IsCollisionDirty = true;
 	}
+
+	UpdateChunkStreaming();
+	StartChunkStreamingTimer();
+}
+
+void AMazeGenerator::UpdateMemoryStats()
+{
+#if STATS
+	//Stats are shared by all maze generators, so only the difference with the last report is added
+	int64 bytesHeld = ChunkGrid.GetAllocatedSize() + MazeWallDiff.GetAllocatedSize() + ErosionScheduler.GetAllocatedSize() + NavigationDirtyAreas.GetAllocatedSize();
+	bytesHeld += DisplayedMaze.GetAllocatedSize() + ChangedWalls.GetAllocatedSize() + AppliedRemovedWalls.GetAllocatedSize()
+		+ WallRings.GetAllocatedSize() + RingStarts.GetAllocatedSize() + SortedWalls.GetAllocatedSize();
+	if (FrontMaze)
+		bytesHeld += FrontMaze->GetAllocatedSize();
+	bytesHeld += MazeRing->GetAllocatedSize() + GenerationScratch->GetAllocatedSize();
+
+	INC_MEMORY_STAT_BY(STAT_MazeBytesHeld, bytesHeld - ReportedBytesHeld);
+	ReportedBytesHeld = bytesHeld;
+#endif
 }
 
-void AMazeGenerator::SpawnInnerWalls(FTransform& floorTransform, FTransform& wallTransform, FRotator& wallRotation, FVector& wallDirection, FVector& wallPos)
+void AMazeGenerator::SpawnOuterWalls(FMazeChunk& chunk)
 {
-	for (auto conn : WallList)
+	AddInstancesWorldSpace(chunk.OuterWallISMC, chunk.TransformTable.OuterWallTransforms);
+}
+
+void AMazeGenerator::SpawnInnerWalls(FMazeChunk& chunk)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MazeSpawnInnerWalls);
+	TRACE_CPUPROFILER_EVENT_SCOPE(AMazeGenerator::SpawnInnerWalls);
+
+	//Every possible inner wall gets a fixed instance, openings are hidden instead of removed
+	const FMazeTransformTable& transformTable = chunk.TransformTable;
+	TArray<FTransform> wallTransforms{};
+	wallTransforms.SetNumUninitialized(transformTable.GetNrOfInnerWalls());
+	ParallelFor(wallTransforms.Num(), [&](int slot)
 	{
-		if (conn->IsWall) {
-			auto fromNode = MazeNodeArray[conn->FromNodeID];
-			auto toNode = MazeNodeArray[conn->ToNodeID];
-			if (fromNode && toNode)
-			{
-				//Spawn wall
-				wallDirection = (toNode->NodePosition - fromNode->NodePosition);
-				wallDirection.Normalize();
-				wallRotation = UKismetMathLibrary::FindLookAtRotation(wallDirection, { 0,0,0 });
-				wallTransform.SetRotation(wallRotation.Quaternion());
-				wallTransform.SetLocation(fromNode->NodePosition + wallDirection * (MazeTileSize / 2));
-				InnerWallTileISMC->AddInstanceWorldSpace(wallTransform);
-			}
-		}
+		const int wallIdx = transformTable.InnerWallIndices[slot];
+		wallTransforms[slot] = transformTable.GetInnerWallTransform(slot, wallIdx != INDEX_NONE && DisplayedMaze.IsWall(wallIdx));
+	});
 
+	AddInstancesWorldSpace(chunk.InnerWallISMC, wallTransforms);
+	UpdateChunkNavigation(chunk);
+}
+
+void AMazeGenerator::UpdateChunkCollision(FMazeChunk& chunk)
+{
+	//Without per instance bodies the instances only draw, a maze change then doesn't touch the physics scene per wall
+	if (WallCollision == EMazeWallCollision::PERINSTANCE)
+		return;
+
+	chunk.InnerWallISMC->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	if (WallCollision != EMazeWallCollision::MERGEDCHUNKS)
+		return;
 
+	if (FreeCollisionComponents.Num() > 0)
+	{
+		chunk.InnerWallCollision = FreeCollisionComponents.Pop(false);
+	}
+	else
+	{
+		chunk.InnerWallCollision = NewObject<UMazeWallCollisionComponent>(this, NAME_None, RF_Transient);
+		chunk.InnerWallCollision->SetCollisionProfileName(InnerWallTileISMC->GetCollisionProfileName());
+		chunk.InnerWallCollision->SetupAttachment(GetRootComponent());
+		chunk.InnerWallCollision->RegisterComponent();
+		CollisionComponents.Add(chunk.InnerWallCollision);
 	}
+	chunk.IsCollisionDirty = true;
 }
 
-void AMazeGenerator::SpawnFloors(FTransform& floorTransform)
+void AMazeGenerator::BuildWallCollision()
 {
-	for (auto node : MazeNodeArray)
+	const UStaticMesh* wallMesh = InnerWallTileISMC->GetStaticMesh();
+	if (WallCollision != EMazeWallCollision::MERGEDCHUNKS || !wallMesh)
+		return;
+
+	//Every chunk whose walls changed since its last build, a newer build makes the results of older ones stale
+	const FBox wallBounds = wallMesh->GetBounds().GetBox();
+	const int buildId = NextCollisionBuildId++;
+	TArray<FMazeChunkCollisionBuild> builds{};
+	for (int chunkIdx = 0; chunkIdx < ChunkGrid.GetNrOfChunks(); chunkIdx++)
 	{
-		floorTransform.SetLocation(node->NodePosition);
-		FloorTileISMC->AddInstanceWorldSpace(floorTransform);
+		FMazeChunk& chunk = ChunkGrid.Chunks[chunkIdx];
+		if (!chunk.IsCollisionDirty || !chunk.InnerWallCollision)
+			continue;
+
+		const FMazeTransformTable& transformTable = chunk.TransformTable;
+		FMazeChunkCollisionBuild& build = builds.AddDefaulted_GetRef();
+		build.ChunkIdx = chunkIdx;
+		build.BuildId = buildId;
+		build.Cells = chunk.Cells;
+		build.EastWallBox = wallBounds.TransformBy(transformTable.GetInnerWallTransform(transformTable.GetInnerWallSlot(chunk.Cells.Min.Y, chunk.Cells.Min.X, FMazeGrid::East), true));
+		build.SouthWallBox = wallBounds.TransformBy(transformTable.GetInnerWallTransform(transformTable.GetInnerWallSlot(chunk.Cells.Min.Y, chunk.Cells.Min.X, FMazeGrid::South), true));
+		chunk.CollisionBuildId = buildId;
+		chunk.IsCollisionDirty = false;
 	}
+	if (builds.Num() == 0)
+		return;
+
+	//The walls on screen change every frame of a wavefront, so the worker gets its own copy
+	TWeakObjectPtr<AMazeGenerator> weakThis(this);
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [weakThis, mazeGrid = DisplayedMaze, builds = MoveTemp(builds)]() mutable
+	{
+		ParallelFor(builds.Num(), [&](int buildIdx)
+		{
+			FMazeChunkCollisionBuild& build = builds[buildIdx];
+			FMazeWallCollision::BuildBoxes(mazeGrid, build.Cells, build.EastWallBox, build.SouthWallBox, build.Boxes);
+		});
+
+		AsyncTask(ENamedThreads::GameThread, [weakThis, builds = MoveTemp(builds)]()
+		{
+			if (AMazeGenerator* mazeGenerator = weakThis.Get())
+				mazeGenerator->OnWallCollisionBuilt(builds);
+		});
+	});
 }
 
-void AMazeGenerator::DrawDebugMazeGrid()
+void AMazeGenerator::OnWallCollisionBuilt(const TArray<FMazeChunkCollisionBuild>& builds)
 {
-	float thickness = 10.f;
-	FVector floorExtent{};
-	floorExtent.X = MazeTileSize / 2 - thickness;
-	floorExtent.Y = MazeTileSize / 2 - thickness;
-	floorExtent.Z = 20.f;
-	//Draw debug nodes
-	for (auto node : MazeNodeArray)
+	for (const FMazeChunkCollisionBuild& build : builds)
+	{
+		//The chunk was unloaded, rebuilt or changed again in the meantime
+		if (!ChunkGrid.Chunks.IsValidIndex(build.ChunkIdx))
+			continue;
+
+		FMazeChunk& chunk = ChunkGrid.Chunks[build.ChunkIdx];
+		if (chunk.CollisionBuildId == build.BuildId && chunk.InnerWallCollision)
+			chunk.InnerWallCollision->SetBoxes(build.Boxes);
+	}
+}
+
+void AMazeGenerator::UpdateChunkNavigation(FMazeChunk& chunk)
+{
+	//The maze graph replaces the inner walls in the nav mesh, otherwise the whole chunk is rebuilt once after its walls are spawned
+	UHierarchicalInstancedStaticMeshComponent* component = chunk.InnerWallISMC;
+	component->SetCanEverAffectNavigation(NavigationMode == EMazeNavigationMode::NAVMESH);
+	if (component->CanEverAffectNavigation())
+		FNavigationSystem::UpdateComponentData(*component);
+}
+
+void AMazeGenerator::UpdateInnerWalls(float frameBudgetMs)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MazeUpdateInnerWalls);
+	TRACE_CPUPROFILER_EVENT_SCOPE(AMazeGenerator::UpdateInnerWalls);
+
+	DirtyChunks.Init(false, ChunkGrid.GetNrOfChunks());
+	NavigationDirtyAreas.Reset();
+	const UStaticMesh* wallMesh = InnerWallTileISMC->GetStaticMesh();
+	const bool isNavigationDirtied = NavigationMode == EMazeNavigationMode::NAVMESH && wallMesh;
+	const FBox wallBounds = wallMesh ? wallMesh->GetBounds().GetBox() : FBox(ForceInit);
+	auto updateWall = [&](int wallIdx, bool isVisible)
+	{
+		int row{}, col{};
+		FMazeGrid::EWallPlane plane{};
+		FrontMaze->GetWallCoordinates(wallIdx, row, col, plane);
+
+		//Unloaded chunks pick up the new walls when they stream in
+		const int chunkIdx = ChunkGrid.GetChunkIndex(row, col);
+		FMazeChunk& chunk = ChunkGrid.Chunks[chunkIdx];
+		if (!chunk.IsLoaded())
+			return;
+
+		const int slot = chunk.TransformTable.GetInnerWallSlot(row, col, plane);
+		chunk.InnerWallISMC->UpdateInstanceTransform(slot, chunk.TransformTable.GetInnerWallTransform(slot, isVisible), true, false, true);
+		DirtyChunks[chunkIdx] = true;
+		INC_DWORD_STAT(STAT_MazeInstancesTouched);
+
+		//A hidden wall is sunk into the floor, so the area of the raised wall covers both states
+		if (isNavigationDirtied)
+			NavigationDirtyAreas.Add(wallBounds.TransformBy(chunk.TransformTable.GetInnerWallTransform(slot, true)));
+	};
+
+	//Only touch the instances of walls that appeared or disappeared, the clock is only read every few walls
+	const bool isFirstSlice = NrOfAppliedWalls == 0;
+	const double endTime = frameBudgetMs > 0 ? FPlatformTime::Seconds() + frameBudgetMs / 1000.0 : MAX_dbl;
+	const int nrOfWallsPerClockRead = 32;
+	AppliedRemovedWalls.Reset();
+	while (NrOfAppliedWalls < ChangedWalls.Num())
 	{
-		DrawDebugString(GetWorld(), node->NodePosition, FString::FromInt(node->MazeNodeId));
-		/*for (auto conn : node.Value.Connections)
+		const int wallIdx = ChangedWalls[NrOfAppliedWalls++];
+		const bool isVisible = FrontMaze->IsWall(wallIdx);
+		if (isVisible)
 		{
-			if (conn.IsWall) {
-				if (auto adjacentNode = MazeNodeGrid.Find(conn.ToNodeID))
-				{
-					FVector pos = node.Value.NodePosition + (adjacentNode->NodePosition - node.Value.NodePosition);
-					DrawDebugSphere(GetWorld(), pos, 50.f, 32, FColor::Blue, true, 15.f, 0, thickness);
-				}
-			}
+			DisplayedMaze.SetWall(wallIdx);
+		}
+		else
+		{
+			DisplayedMaze.RemoveWall(wallIdx);
+			AppliedRemovedWalls.Add(wallIdx);
+		}
+		updateWall(wallIdx, isVisible);
 
-		}*/
+		if (NrOfAppliedWalls % nrOfWallsPerClockRead == 0 && FPlatformTime::Seconds() > endTime)
+			break;
 	}
 
-	//Draw maze path
-	/*for (auto node : MazeNodePath)
+	for (TConstSetBitIterator<> it(DirtyChunks); it; ++it)
 	{
-		DrawDebugSphere(GetWorld(), node->NodePosition, 100.f, 10, FColor::Red, true, 5.f, 0, 15.f);
-	}*/
+		//Moved instances can leave their clusters, the tree of every changed chunk is rebuilt on a worker and drawn when it is done
+		FMazeChunk& chunk = ChunkGrid.Chunks[it.GetIndex()];
+		chunk.InnerWallISMC->BuildTreeIfOutdated(true, true);
+		chunk.IsCollisionDirty = true;
+	}
+	BuildWallCollision();
+
+	//Only the nav mesh tiles the changed walls touch are rebuilt
+	UNavigationSystemV1* navigationSystem = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if (navigationSystem && NavigationDirtyAreas.Num() > 0)
+		navigationSystem->AddDirtyAreas(NavigationDirtyAreas, ENavigationDirtyFlag::All);
+
+	//The solver copies the whole maze, so it only gets the walls on screen once the wavefront is done, the fx follow every slice
+	if (!IsChangingWalls())
+		UpdateMazeSolver();
+	if (ErodeOldWalls)
+		SpawnErosionFX(AppliedRemovedWalls, isFirstSlice);
 }
 
-void AMazeGenerator::GenerateDFSMazeAsync()
+void AMazeGenerator::SortChangedWalls()
 {
-	(new FAutoDeleteAsyncTask<RandomDepthFirstSearch>(MazeStartPosition, NrOfMazeColumns, NrOfMazeRows,
-		MazeTileSize, MazeNodeArray, WallList))->StartBackgroundTask();
+	//Walls are sorted in rings of one tile around the origin with a counting sort, so the sort itself is no spike either
+	const float mazeTileSize = FMath::Max(FrontMaze->MazeTileSize, 1.f);
+	FVector origin = FrontMaze->MazeStartPosition + FVector((FrontMaze->NrOfMazeColumns / 2.f - 1) * mazeTileSize, -FrontMaze->NrOfMazeRows / 2.f * mazeTileSize, 0);
+	if (WavefrontOrigin == EMazeWavefrontOrigin::PLAYER)
+	{
+		TArray<FVector> playerLocations{};
+		GetPlayerLocations(playerLocations);
+		if (playerLocations.Num() > 0)
+			origin = playerLocations[0];
+	}
+
+	int nrOfRings = 0;
+	WallRings.SetNumUninitialized(ChangedWalls.Num());
+	for (int changeIdx = 0; changeIdx < ChangedWalls.Num(); changeIdx++)
+	{
+		WallRings[changeIdx] = FMath::FloorToInt(FVector::Dist2D(FrontMaze->GetWallPosition(ChangedWalls[changeIdx]), origin) / mazeTileSize);
+		nrOfRings = FMath::Max(nrOfRings, WallRings[changeIdx] + 1);
+	}
+
+	RingStarts.Init(0, nrOfRings + 1);
+	for (int ring : WallRings)
+	{
+		RingStarts[ring + 1]++;
+	}
+	for (int ring = 0; ring < nrOfRings; ring++)
+	{
+		RingStarts[ring + 1] += RingStarts[ring];
+	}
+
+	SortedWalls.SetNumUninitialized(ChangedWalls.Num());
+	for (int changeIdx = 0; changeIdx < ChangedWalls.Num(); changeIdx++)
+	{
+		SortedWalls[RingStarts[WallRings[changeIdx]]++] = ChangedWalls[changeIdx];
+	}
+	Swap(ChangedWalls, SortedWalls);
 }
 
-void AMazeGenerator::GenerateDFSMaze()
+void AMazeGenerator::FinishWallChanges()
 {
-	RandomDepthFirstSearch randomDFS(MazeStartPosition, NrOfMazeColumns, NrOfMazeRows,
-		MazeTileSize, MazeNodeArray, WallList);
-	randomDFS.DoWork();
+	if (IsChangingWalls())
+		UpdateInnerWalls(0);
 }
 
-void AMazeGenerator::GenerateKruskalsMazeAsync()
+void AMazeGenerator::SpawnFloors(FMazeChunk& chunk)
 {
+	AddInstancesWorldSpace(chunk.FloorISMC, chunk.TransformTable.FloorTransforms);
 }
 
-void AMazeGenerator::UpdateChangeMaze(float delta)
+void AMazeGenerator::LoadChunk(FMazeChunk& chunk)
 {
-	ElapsedTimeUntilMazeChange += delta;
-	if (ElapsedTimeUntilMazeChange >= MazeChangeTimer) {
-		//Create new maze
-		InnerWallTileISMC->ClearInstances();
-		SpawnMeshes(false, false, true);
+	SCOPE_CYCLE_COUNTER(STAT_MazeLoadChunk);
+	TRACE_CPUPROFILER_EVENT_SCOPE(AMazeGenerator::LoadChunk);
 
-		//Spawn erosion walls
-		if (ErodeOldWalls) {
-			FString text = FString::FromInt(OldErosionWallList.Num());
-			if (GEngine)
-				GEngine->AddOnScreenDebugMessage(-1, 3.f, FColor::Blue, text);
+	chunk.FloorISMC = AcquireChunkComponent(FloorTileISMC, FreeFloorComponents);
+	chunk.InnerWallISMC = AcquireChunkComponent(InnerWallTileISMC, FreeInnerWallComponents);
+	chunk.OuterWallISMC = AcquireChunkComponent(OuterWallTileISMC, FreeOuterWallComponents);
+	UpdateChunkCollision(chunk);
 
-			//Remove walls that are still being used
-			for (size_t oldWallidx = 0; oldWallidx < OldErosionWallList.Num(); oldWallidx++)
-			{
-				if (OldErosionWallList[oldWallidx]->IsWall && !WallList[oldWallidx]->IsWall)
-					OldErosionWallList.RemoveAt(oldWallidx);
-			}
+	if (!chunk.TransformTable.Matches(*FrontMaze, chunk.Cells))
+		chunk.TransformTable.Build(*FrontMaze, chunk.Cells);
 
-			text = FString::FromInt(OldErosionWallList.Num());
-			if (GEngine)
-				GEngine->AddOnScreenDebugMessage(-1, 3.f, FColor::Red, text);
+	SpawnOuterWalls(chunk);
+	SpawnFloors(chunk);
+	SpawnInnerWalls(chunk);
 
+#if STATS
+	INC_DWORD_STAT(STAT_MazeLoadedChunks);
+	NrOfReportedChunks++;
+#endif
+}
 
-			
+void AMazeGenerator::UnloadChunk(FMazeChunk& chunk)
+{
+	ReleaseChunkComponent(chunk.FloorISMC, FloorTileISMC, FreeFloorComponents);
+	ReleaseChunkComponent(chunk.InnerWallISMC, InnerWallTileISMC, FreeInnerWallComponents);
+	ReleaseChunkComponent(chunk.OuterWallISMC, OuterWallTileISMC, FreeOuterWallComponents);
+	chunk.FloorISMC = nullptr;
+	chunk.InnerWallISMC = nullptr;
+	chunk.OuterWallISMC = nullptr;
+
+	if (chunk.InnerWallCollision)
+	{
+		chunk.InnerWallCollision->SetBoxes({});
+		FreeCollisionComponents.Add(chunk.InnerWallCollision);
+		chunk.InnerWallCollision = nullptr;
+	}
+	chunk.CollisionBuildId = INDEX_NONE;
+	chunk.IsCollisionDirty = false;
 
-			//Spawn eroding walls fx
-			FRotator wallRotation{};
-			FVector wallDirection{};
-			FVector wallLocation{};
-			for (auto erosionWall: OldErosionWallList)
-			{
-				if (erosionWall->IsWall) {
-					auto fromNode = MazeNodeArray[erosionWall->FromNodeID];
-					auto toNode = MazeNodeArray[erosionWall->ToNodeID];
-					if (fromNode && toNode)
-					{
-						//Spawn wall			
-						wallDirection = (toNode->NodePosition - fromNode->NodePosition);
-						wallDirection.Normalize();
-						wallLocation = fromNode->NodePosition + wallDirection * (MazeTileSize / 2);
-						wallRotation = UKismetMathLibrary::FindLookAtRotation(wallDirection, { 0,0,0 });
-						UNiagaraFunctionLibrary::SpawnSystemAtLocation(GetWorld(),
-							ErosionFX, wallLocation, wallRotation);
-					}
-				}
-			}
-
-			//Save wall list as old list
-			OldErosionWallList = WallList;
+	//Only loaded chunks keep their transforms
+	chunk.TransformTable.Empty();
+
+#if STATS
+	DEC_DWORD_STAT(STAT_MazeLoadedChunks);
+	NrOfReportedChunks--;
+#endif
+}
+
+void AMazeGenerator::UnloadChunks()
+{
+	for (FMazeChunk& chunk : ChunkGrid.Chunks)
+	{
+		if (chunk.IsLoaded())
+			UnloadChunk(chunk);
+	}
+}
+
+void AMazeGenerator::UpdateChunkStreaming()
+{
+	SCOPE_CYCLE_COUNTER(STAT_MazeChunkStreaming);
+	TRACE_CPUPROFILER_EVENT_SCOPE(AMazeGenerator::UpdateChunkStreaming);
+
+	//Outside of play there are no players to stream around, so the whole maze is loaded
+	if (!IsStreamingChunks())
+	{
+		for (FMazeChunk& chunk : ChunkGrid.Chunks)
+		{
+			if (!chunk.IsLoaded())
+				LoadChunk(chunk);
 		}
+		BuildWallCollision();
+		UpdateMemoryStats();
+		return;
+	}
 
+	//The server needs the floors and walls around every player for their collision, a dedicated server has no local players at all
+	TArray<FVector> playerLocations{};
+	GetPlayerLocations(playerLocations, HasAuthority());
 
-		ElapsedTimeUntilMazeChange = 0;
+	//Chunks unload a bit further than they load, so a player on the edge doesn't reload the same chunk
+	const float loadDistanceSquared = FMath::Square(ChunkStreamingDistance);
+	const float unloadDistanceSquared = FMath::Square(ChunkStreamingDistance * 1.25f);
+	TArray<TPair<float, int>> chunksToLoad{};
+	for (int chunkIdx = 0; chunkIdx < ChunkGrid.GetNrOfChunks(); chunkIdx++)
+	{
+		FMazeChunk& chunk = ChunkGrid.Chunks[chunkIdx];
+		const float distanceSquared = ChunkGrid.GetSquaredDistance(chunkIdx, playerLocations);
+		if (chunk.IsLoaded() && distanceSquared > unloadDistanceSquared)
+			UnloadChunk(chunk);
+		else if (!chunk.IsLoaded() && distanceSquared <= loadDistanceSquared)
+			chunksToLoad.Emplace(distanceSquared, chunkIdx);
+	}
 
-		switch (MazeGenerationAlgorithm)
+	//The closest chunks load first, the rest waits for the next update
+	chunksToLoad.Sort([](const TPair<float, int>& a, const TPair<float, int>& b) { return a.Key < b.Key; });
+	const int nrOfLoads = FMath::Min(chunksToLoad.Num(), MaxChunkLoadsPerUpdate);
+	for (int loadIdx = 0; loadIdx < nrOfLoads; loadIdx++)
+	{
+		LoadChunk(ChunkGrid.Chunks[chunksToLoad[loadIdx].Value]);
+	}
+	BuildWallCollision();
+	UpdateMemoryStats();
+}
+
+void AMazeGenerator::StartChunkStreamingTimer()
+{
+	if (IsStreamingChunks())
+		GetWorldTimerManager().SetTimer(ChunkStreamingTimerHandle, this, &AMazeGenerator::UpdateChunkStreaming, ChunkStreamingInterval, true);
+	else
+		GetWorldTimerManager().ClearTimer(ChunkStreamingTimerHandle);
+}
+
+UHierarchicalInstancedStaticMeshComponent* AMazeGenerator::AcquireChunkComponent(UHierarchicalInstancedStaticMeshComponent* templateComponent, TArray<UHierarchicalInstancedStaticMeshComponent*>& freeComponents)
+{
+	//A maze of one chunk uses the components of the actor
+	if (MazeChunkSize <= 0)
+	{
+		ApplyInstanceSettings(templateComponent);
+		return templateComponent;
+	}
+
+	if (freeComponents.Num() > 0)
+		return freeComponents.Pop(false);
+
+	UHierarchicalInstancedStaticMeshComponent* component = NewObject<UHierarchicalInstancedStaticMeshComponent>(this, templateComponent->GetClass(), NAME_None, RF_Transient);
+	component->SetMobility(templateComponent->Mobility);
+	component->SetStaticMesh(templateComponent->GetStaticMesh());
+	for (int materialIdx = 0; materialIdx < templateComponent->GetNumMaterials(); materialIdx++)
+	{
+		component->SetMaterial(materialIdx, templateComponent->GetMaterial(materialIdx));
+	}
+	component->SetCollisionProfileName(templateComponent->GetCollisionProfileName());
+	component->SetCastShadow(templateComponent->CastShadow);
+	ApplyInstanceSettings(component);
+	component->SetupAttachment(GetRootComponent());
+	component->RegisterComponent();
+	ChunkComponents.Add(component);
+	return component;
+}
+
+void AMazeGenerator::ApplyInstanceSettings(UHierarchicalInstancedStaticMeshComponent* component) const
+{
+	component->bAutoRebuildTreeOnInstanceChanges = false;
+	component->SetCullDistances(InstanceStartCullDistance, InstanceEndCullDistance);
+	component->bOverrideMinLOD = InstanceMinLOD > 0;
+	component->MinLOD = InstanceMinLOD;
+}
+
+void AMazeGenerator::ReleaseChunkComponent(UHierarchicalInstancedStaticMeshComponent* component, UHierarchicalInstancedStaticMeshComponent* templateComponent, TArray<UHierarchicalInstancedStaticMeshComponent*>& freeComponents)
+{
+	component->ClearInstances();
+	if (component != templateComponent)
+		freeComponents.Add(component);
+}
+
+bool AMazeGenerator::IsStreamingChunks() const
+{
+	const UWorld* world = GetWorld();
+	return MazeChunkSize > 0 && world && world->IsGameWorld();
+}
+
+void AMazeGenerator::GetPlayerLocations(TArray<FVector>& outLocations, bool includeRemotePlayers) const
+{
+	FVector viewLocation{};
+	FRotator viewRotation{};
+	for (FConstPlayerControllerIterator it = GetWorld()->GetPlayerControllerIterator(); it; ++it)
+	{
+		APlayerController* playerController = it->Get();
+		if (!playerController)
+			continue;
+
+		if (playerController->IsLocalController())
 		{
-		case EMazeAlgorithm::RANDOMDEPTHFIRSTSEARCH:
-			GenerateDFSMazeAsync();
-			break;
-		case EMazeAlgorithm::RANDOMKRUSKALS:
-			break;
-		case EMazeAlgorithm::RANDOMPRISMS:
-			break;
-		default:
-			break;
+			playerController->GetPlayerViewPoint(viewLocation, viewRotation);
+			outLocations.Add(viewLocation);
+		}
+		else if (includeRemotePlayers)
+		{
+			//Only the server knows the controllers of remote players, their pawn is where the collision is needed
+			if (const APawn* pawn = playerController->GetPawn())
+				outLocations.Add(pawn->GetActorLocation());
+		}
+	}
+}
+
+void AMazeGenerator::UpdateMazeSolver()
+{
+	//The solver copies the walls, the front buffer is reused for the maze after the next one
+	UWorld* world = GetWorld();
+	if (UMazeSolverSubsystem* mazeSolver = world ? world->GetSubsystem<UMazeSolverSubsystem>() : nullptr)
+		mazeSolver->SetMaze(this, DisplayedMaze, FrontMazeEpoch);
+}
+
+void AMazeGenerator::DrawDebugMazeGrid()
+{
+	//Draw debug nodes
+	for (int cellIdx = 0; cellIdx < FrontMaze->GetNrOfCells(); cellIdx++)
+	{
+		DrawDebugString(GetWorld(), FrontMaze->GetCellPosition(cellIdx), FString::FromInt(cellIdx));
+	}
+}
+
+void AMazeGenerator::SpawnErosionFX(const TArray<int>& removedWalls, bool isNewChange)
+{
+	//Walls of the old maze that are openings in the new maze, spawned over the next frames near the players
+	if (isNewChange)
+		ErosionScheduler.Schedule(*FrontMaze, removedWalls, ErosionFXMaxDelay);
+	else
+		ErosionScheduler.Append(*FrontMaze, removedWalls, ErosionFXMaxDelay);
+	if (ErosionScheduler.HasPendingWalls())
+		SetActorTickEnabled(true);
+}
+
+void AMazeGenerator::UpdateErosionFX()
+{
+	TArray<FVector> playerLocations{};
+	GetPlayerLocations(playerLocations);
+
+	ErosionScheduler.Update(GetWorld(), ErosionFX, playerLocations, ErosionFXRadius, MaxErosionFXPerFrame, ErosionFXFrameBudgetMs);
+	ErosionStats = ErosionScheduler.GetStats();
+}
+
+void AMazeGenerator::RequestNextMazes()
+{
+	TWeakObjectPtr<AMazeGenerator> weakThis(this);
+	while (true)
+	{
+		//A mutation starts from the maze of the epoch before, so it waits until that maze is generated
+		const int epoch = MazeRing->GetNextEpoch();
+		const FMazeGrid* previousMaze = nullptr;
+		if (MazeChangeMode == EMazeChangeMode::MUTATE && GetMutationKeyframe(epoch) != epoch)
+		{
+			const FMazeGenerationRing::FSlot* previousSlot = MazeRing->FindSlot(epoch - 1);
+			if (previousSlot && !previousSlot->IsReady.Load())
+				break;
+
+			if (previousSlot)
+				previousMaze = previousSlot->Maze.Get();
+			else if (FrontMazeEpoch == epoch - 1 && FrontMazeSeed == GetEpochSeed(FrontMazeEpoch))
+				previousMaze = FrontMaze.Get();
 		}
+
+		TSharedPtr<FMazeGenerationRing::FSlot, ESPMode::ThreadSafe> slot = MazeRing->RequestNext(MaxGenerationWorkers);
+		if (!slot)
+			break;
+
+		//The buffers of the slot are owned by the worker until it sets the ready flag
+		slot->Seed = GetEpochSeed(epoch);
+		if (previousMaze)
+			*slot->Maze = *previousMaze;
+		else
+			slot->Maze->Init(MazeStartPosition, NrOfMazeColumns, NrOfMazeRows, MazeTileSize);
+
+		TSharedRef<FMazeGenerationRing::FSlot, ESPMode::ThreadSafe> slotRef = slot.ToSharedRef();
+		(new FAutoDeleteAsyncTask<FMazeGenerationTask>(GetGenerationSettings(epoch, previousMaze != nullptr), slot->Maze.ToSharedRef(), slot->Scratch.ToSharedRef(), [weakThis, slotRef](int nrOfMutationMoves)
+		{
+			slotRef->MarkReady(nrOfMutationMoves);
+
+			//The game thread only hears about it to start the next worker and to catch up on a change that is due
+			AsyncTask(ENamedThreads::GameThread, [weakThis]()
+			{
+				if (AMazeGenerator* mazeGenerator = weakThis.Get())
+					mazeGenerator->OnNextMazeGenerated();
+			});
+		}))->StartBackgroundTask();
 	}
 
+	UpdateGenerationStats();
+}
 
+void AMazeGenerator::UpdateGenerationStats()
+{
+	GenerationStats.NrOfReadyMazes = MazeRing->GetNrOfReady();
+	GenerationStats.NrOfGeneratingMazes = MazeRing->GetNrOfGenerating();
+	GenerationStats.NrOfRunningWorkers = MazeRing->GetNrOfRunningWorkers();
+
+#if STATS
+	//Stats are shared by all maze generators, so only the difference with the last report is added
+	INC_DWORD_STAT_BY(STAT_MazeReadyMazes, GenerationStats.NrOfReadyMazes - NrOfReportedReadyMazes);
+	INC_DWORD_STAT_BY(STAT_MazeGeneratingMazes, GenerationStats.NrOfGeneratingMazes - NrOfReportedGeneratingMazes);
+	NrOfReportedReadyMazes = GenerationStats.NrOfReadyMazes;
+	NrOfReportedGeneratingMazes = GenerationStats.NrOfGeneratingMazes;
+#endif
+}
+
+FMazeGenerationSettings AMazeGenerator::GetGenerationSettings(int32 epoch, bool hasPreviousMaze) const
+{
+	FMazeGenerationSettings settings{};
+	settings.Algorithm = MazeGenerationAlgorithm;
+	settings.Seed = GetEpochSeed(epoch);
+	settings.ParallelTileSize = ParallelTileSize;
+	if (MazeChangeMode != EMazeChangeMode::MUTATE)
+		return settings;
+
+	//Only the mazes of keyframes are generated, clients that join later replay the mutations since the last keyframe or the first epoch
+	const int32 keyframe = GetMutationKeyframe(epoch);
+	if (keyframe == epoch)
+		return settings;
+
+	settings.NrOfMutationMoves = MazeMutationStrength;
+	settings.IsMutatingBuffer = hasPreviousMaze;
+	if (!hasPreviousMaze)
+		settings.Seed = GetEpochSeed(keyframe);
+	for (int32 mutationEpoch = hasPreviousMaze ? epoch : keyframe + 1; mutationEpoch <= epoch; mutationEpoch++)
+	{
+		settings.MutationSeeds.Add(GetEpochSeed(mutationEpoch));
+	}
+	return settings;
+}
+
+int32 AMazeGenerator::GetMutationKeyframe(int32 epoch) const
+{
+	if (MazeMutationKeyframeInterval <= 0)
+		return 0;
+	return epoch - epoch % MazeMutationKeyframeInterval;
+}
+
+void AMazeGenerator::OnNextMazeGenerated()
+{
+	SCOPE_CYCLE_COUNTER(STAT_MazeHandoff);
+	TRACE_CPUPROFILER_EVENT_SCOPE(AMazeGenerator::OnNextMazeGenerated);
+
+	//A worker is free again, this can also be a maze of a ring that was reset since
+	RequestNextMazes();
+
+	//The timer already ran out while this maze was being generated
+	if (IsMazeChangeDue && MazeRing->IsFirstReady())
+		ChangeMaze();
+}
+
+void AMazeGenerator::OnRep_MazeEpoch()
+{
+	//GenerateMaze picks up the epoch if this client has no maze yet
+	if (FrontMazeEpoch == INDEX_NONE || GetEpochSeed(MazeEpoch) == FrontMazeSeed)
+		return;
+
+	//The next maze is usually generated already, a client that fell behind or a new seed starts the ring at the epoch of the server
+	if (!MazeRing->IsFirstRequested(MazeEpoch, GetEpochSeed(MazeEpoch)))
+	{
+		MazeRing->Reset(NrOfPregeneratedMazes, MazeEpoch);
+		RequestNextMazes();
+	}
+
+	OnMazeChangeTimer();
+}
+
+void AMazeGenerator::OnMazeChangeTimer()
+{
+	if (MazeRing->IsFirstReady())
+	{
+		ChangeMaze();
+	}
+	else if (!IsMazeChangeDue)
+	{
+		//The workers fell behind, the change happens as soon as the maze is ready
+		IsMazeChangeDue = true;
+		MazeChangeDueTime = FPlatformTime::Seconds();
+	}
+}
+
+void AMazeGenerator::StartMazeChangeTimer()
+{
+	//Only the server decides when the maze changes
+	UWorld* world = GetWorld();
+	if (world && world->IsGameWorld() && HasAuthority())
+		GetWorldTimerManager().SetTimer(MazeChangeTimerHandle, this, &AMazeGenerator::OnMazeChangeTimer, MazeChangeTimer, false);
+}
+
+void AMazeGenerator::ChangeMaze()
+{
+	SCOPE_CYCLE_COUNTER(STAT_MazeChange);
+	TRACE_CPUPROFILER_EVENT_SCOPE(AMazeGenerator::ChangeMaze);
+
+	//How late the maze is, a change only waits if the ring ran empty
+	const float changeDelayMs = IsMazeChangeDue ? (FPlatformTime::Seconds() - MazeChangeDueTime) * 1000 : 0;
+	IsMazeChangeDue = false;
+
+	//The next maze is here, a wavefront that is still running finishes at once
+	FinishWallChanges();
+
+	//Publish the first maze of the ring, the buffer of the old maze goes back into the ring for a next epoch
+	double latencySeconds = 0;
+	MazeRing->PopFirst(FrontMaze, FrontMazeEpoch, FrontMazeSeed, latencySeconds, GenerationStats.LastNrOfMutationMoves);
+	GenerationStats.LastChangeDelayMs = changeDelayMs;
+	GenerationStats.LastGenerationLatencyMs = latencySeconds * 1000;
+	GenerationStats.LastNrOfRequestedMutationMoves = MazeChangeMode == EMazeChangeMode::MUTATE && GetMutationKeyframe(FrontMazeEpoch) != FrontMazeEpoch ? MazeMutationStrength : 0;
+	INC_DWORD_STAT_BY(STAT_MazeMutationMoves, GenerationStats.LastNrOfMutationMoves);
+	SET_FLOAT_STAT(STAT_MazeChangeDelay, GenerationStats.LastChangeDelayMs);
+	SET_FLOAT_STAT(STAT_MazeGenerationLatency, GenerationStats.LastGenerationLatencyMs);
+	if (HasAuthority())
+		MazeEpoch = FrontMazeEpoch;
+
+	//Compare the new maze with the walls on screen, walls can only be compared between mazes of the same dimensions
+	ChangedWalls.Reset();
+	NrOfAppliedWalls = 0;
+	if (ChunkGrid.Matches(*FrontMaze, MazeChunkSize))
+	{
+		MazeWallDiff.Compute(DisplayedMaze.Walls, FrontMaze->Walls);
+		INC_DWORD_STAT_BY(STAT_MazeWallsChanged, MazeWallDiff.GetNrOfChangedWalls());
+		ChangedWalls.Append(MazeWallDiff.RemovedWalls);
+		ChangedWalls.Append(MazeWallDiff.AddedWalls);
+
+		//A wavefront applies the walls closest to the origin first and the rest over the next frames
+		if (ChangeAsWavefront)
+			SortChangedWalls();
+		UpdateInnerWalls(ChangeAsWavefront ? WavefrontFrameBudgetMs : 0);
+		if (IsChangingWalls())
+			SetActorTickEnabled(true);
+	}
+	else
+	{
+		MazeWallDiff.Reset();
+		DisplayedMaze = *FrontMaze;
+		SpawnMeshes();
+		UpdateMazeSolver();
+	}
+
+	//The Walls Changed stat counts the same walls, the message is only for debugging
+	if (DrawDebug && GEngine)
+		GEngine->AddOnScreenDebugMessage(-1, 3.f, FColor::Red, FString::Printf(TEXT("Walls removed: %d, added: %d"),
+			MazeWallDiff.RemovedWalls.Num(), MazeWallDiff.AddedWalls.Num()));
+
+	RequestNextMazes();
+	StartMazeChangeTimer();
+	UpdateMemoryStats();
+
+	//The server moved on while this client was generating
+	if (!HasAuthority())
+		OnRep_MazeEpoch();
 }
 
 // Called every frame
@@ -283,6 +918,11 @@ void AMazeGenerator::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	UpdateChangeMaze(DeltaTime);
-}
+	if (IsChangingWalls())
+		UpdateInnerWalls(WavefrontFrameBudgetMs);
+	UpdateErosionFX();
 
+	//Only tick while there is work spread over frames
+	if (!IsChangingWalls() && !ErosionScheduler.HasPendingWalls())
+		SetActorTickEnabled(false);
+}
@@ -4,6 +4,10 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "MazeGrid.h"
+#include "MazeChunkGrid.h"
+#include "MazeWallDiff.h"
+#include "MazeErosionScheduler.h"
 #include "MazeGenerator.generated.h"
 
 UENUM(BlueprintType)
@@ -11,71 +15,71 @@ enum class EMazeAlgorithm : uint8 {
 	RANDOMDEPTHFIRSTSEARCH = 0 UMETA(DisplayName = "Randomized Depth-First Search"),
 	RANDOMKRUSKALS = 1 UMETA(DisplayName = "Randomized Kruskal's"),
 	RANDOMPRISMS = 2 UMETA(DisplayName = "Randomized Prim's"),
+	RANDOMELLERS = 3 UMETA(DisplayName = "Eller's"),
+	RANDOMBINARYTREE = 4 UMETA(DisplayName = "Binary Tree"),
+	RANDOMSIDEWINDER = 5 UMETA(DisplayName = "Sidewinder"),
 };
 
+UENUM(BlueprintType)
+enum class EMazeChangeMode : uint8 {
+	REGENERATE = 0 UMETA(DisplayName = "Regenerate"),
+	MUTATE = 1 UMETA(DisplayName = "Mutate"),
+};
 
-USTRUCT()
-struct FMazeNodeConnection
-{
-	GENERATED_BODY()
-		int FromNodeID;
-	int ToNodeID;
-	FMazeNode* FromNode;
-	FMazeNode* ToNode;
-
-	bool IsWall;
-
-	FMazeNodeConnection(int fromNodeID, int toNodeID)
-		:FromNodeID(fromNodeID)
-		, ToNodeID(toNodeID)
-		, FromNode(nullptr)
-		, ToNode(nullptr)
-		, IsWall(true)
-	{
-
-	}
-
-	FMazeNodeConnection()
-		:FromNodeID(-1)
-		, ToNodeID(-1)
-		, FromNode(nullptr)
-		, ToNode(nullptr)
-		, IsWall(true)
-	{
-
-	}
+UENUM(BlueprintType)
+enum class EMazeWavefrontOrigin : uint8 {
+	MAZECENTER = 0 UMETA(DisplayName = "Maze Center"),
+	PLAYER = 1 UMETA(DisplayName = "Player"),
+};
+
+UENUM(BlueprintType)
+enum class EMazeNavigationMode : uint8 {
+	NAVMESH = 0 UMETA(DisplayName = "Nav Mesh"),
+	MAZEGRAPH = 1 UMETA(DisplayName = "Maze Graph"),
+};
+
+UENUM(BlueprintType)
+enum class EMazeWallCollision : uint8 {
+	PERINSTANCE = 0 UMETA(DisplayName = "Per Instance"),
+	MERGEDCHUNKS = 1 UMETA(DisplayName = "Merged Chunks"),
+	GRIDQUERIES = 2 UMETA(DisplayName = "Grid Queries"),
 };
 
-USTRUCT()
-struct FMazeNode
+USTRUCT(BlueprintType)
+struct FMazeGenerationStats
 {
 	GENERATED_BODY()
 
-		int MazeNodeId;
-	FVector NodePosition;
-	bool IsVisited;
-	TArray<FMazeNodeConnection*> Connections;
-
-
-	FMazeNode(int nodeID, FVector nodePosition)
-		:MazeNodeId(nodeID)
-		, NodePosition(nodePosition)
-		, IsVisited(false)
-		, Connections()
-	{
-		Connections = {};
-	}
-
-	FMazeNode()
-		:MazeNodeId(-1)
-		, NodePosition()
-		, IsVisited(false)
-	{
-		Connections = {};
-	}
+	/*Next mazes that are generated and waiting for their change.*/
+	UPROPERTY(BlueprintReadOnly, VisibleInstanceOnly, Category = "Maze settings")
+		int NrOfReadyMazes = 0;
+
+	/*Next mazes that workers are generating right now.*/
+	UPROPERTY(BlueprintReadOnly, VisibleInstanceOnly, Category = "Maze settings")
+		int NrOfGeneratingMazes = 0;
+
+	/*Workers that are generating right now, more than the generating mazes when a reset dropped mazes that were still being generated.*/
+	UPROPERTY(BlueprintReadOnly, VisibleInstanceOnly, Category = "Maze settings")
+		int NrOfRunningWorkers = 0;
+
+	/*How long in milliseconds the last change had to wait for its maze, 0 if it was ready in time.*/
+	UPROPERTY(BlueprintReadOnly, VisibleInstanceOnly, Category = "Maze settings")
+		float LastChangeDelayMs = 0.f;
 
+	/*How long in milliseconds the maze of the last change took from its request until it was ready, waiting for a worker included.*/
+	UPROPERTY(BlueprintReadOnly, VisibleInstanceOnly, Category = "Maze settings")
+		float LastGenerationLatencyMs = 0.f;
+
+	/*The moves the mutation of the last change made, only fewer than the mutation strength when it found no wall to open.*/
+	UPROPERTY(BlueprintReadOnly, VisibleInstanceOnly, Category = "Maze settings")
+		int LastNrOfMutationMoves = 0;
+
+	/*The moves the mutation of the last change was asked to make, 0 when the last change wasn't a mutation.*/
+	UPROPERTY(BlueprintReadOnly, VisibleInstanceOnly, Category = "Maze settings")
+		int LastNrOfRequestedMutationMoves = 0;
 };
 
+
 UCLASS()
 class MAZEGENERATION_API AMazeGenerator : public AActor
 {
@@ -88,6 +92,16 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Maze")
 		void GenerateMaze();
 
+	/*The seed the maze of an epoch is generated with.*/
+	UFUNCTION(BlueprintPure, Category = "Maze")
+		int32 GetEpochSeed(int32 epoch) const;
+
+	/*Traces against the inner and outer walls of the current maze without physics, walls are planes on the cell borders. Only the XY-plane is traced.*/
+	UFUNCTION(BlueprintCallable, Category = "Maze")
+		bool LineTraceWalls(FVector start, FVector end, FVector& outHitLocation, FVector& outHitNormal) const;
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
 	/*The start point of the maze.*/
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze settings")
 		FVector MazeStartPosition = {};
@@ -108,10 +122,94 @@ public:
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze settings")
 		EMazeAlgorithm MazeGenerationAlgorithm = EMazeAlgorithm::RANDOMDEPTHFIRSTSEARCH;
 
+	/*Mazes bigger than this amount of cells along a side are generated in tiles on all cores, 0 generates the whole maze on one core. Rounded up to a multiple of 64.*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze settings", meta = (ClampMin = "0"))
+		int ParallelTileSize = 256;
+
+	/*The seed of the maze, every maze is generated with a seed made from this seed and its epoch. 0 picks a random seed when the maze is first generated.*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, ReplicatedUsing = OnRep_MazeEpoch, Category = "Maze settings")
+		int32 MazeSeed = 0;
+
+	/*The amount of times the maze changed, clients generate the maze of this epoch themselves.*/
+	UPROPERTY(BlueprintReadOnly, VisibleInstanceOnly, ReplicatedUsing = OnRep_MazeEpoch, Category = "Maze settings")
+		int32 MazeEpoch = 0;
+
 	/*How long it takes to change the maze.*/
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze settings")
 		float MazeChangeTimer = 5.f;
 
+	/*Regenerate: every change is a new maze. Mutate: every change moves a few walls of the maze before it, the maze stays perfect.*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze settings")
+		EMazeChangeMode MazeChangeMode = EMazeChangeMode::REGENERATE;
+
+	/*The amount of walls a mutation opens, it closes as many other walls.*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze settings", meta = (ClampMin = "1", EditCondition = "MazeChangeMode == EMazeChangeMode::MUTATE"))
+		int MazeMutationStrength = 8;
+
+	/*Every this many epochs the maze is generated anew instead of mutated, so a client that joins late only replays the mutations since the last of these. 0 never generates a new maze, late clients then replay every epoch on a worker.*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze settings", meta = (ClampMin = "0", EditCondition = "MazeChangeMode == EMazeChangeMode::MUTATE"))
+		int MazeMutationKeyframeInterval = 0;
+
+	/*How many of the next mazes are generated ahead of time, more mazes hide generations that take longer than the change timer for a while.*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze settings", meta = (ClampMin = "1"))
+		int NrOfPregeneratedMazes = 2;
+
+	/*The maximum amount of workers generating next mazes at the same time.*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze settings", meta = (ClampMin = "1"))
+		int MaxGenerationWorkers = 1;
+
+	/*How far the generation of the next mazes is ahead of the changes.*/
+	UPROPERTY(BlueprintReadOnly, VisibleInstanceOnly, Category = "Maze settings")
+		FMazeGenerationStats GenerationStats;
+
+	/*Spreads a maze change over multiple frames, the walls change in rings around the wavefront origin.*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze settings")
+		bool ChangeAsWavefront = false;
+
+	/*Where the wavefront starts, the first local player or the center of the maze if there is no player.*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze settings")
+		EMazeWavefrontOrigin WavefrontOrigin = EMazeWavefrontOrigin::MAZECENTER;
+
+	/*The maximum time in milliseconds spent on changing walls in one frame of a wavefront.*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze settings", meta = (ClampMin = "0.01"))
+		float WavefrontFrameBudgetMs = 1.f;
+
+	/*The amount of cells along each side of a chunk, every chunk has its own meshes. The whole maze is one chunk if this is 0.*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze streaming", meta = (ClampMin = "0"))
+		int MazeChunkSize = 32;
+
+	/*Chunks within this distance of a local player are loaded, chunks further away are unloaded.*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze streaming", meta = (ClampMin = "0"))
+		float ChunkStreamingDistance = 20000.f;
+
+	/*How often in seconds the loaded chunks are updated.*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze streaming", meta = (ClampMin = "0.01"))
+		float ChunkStreamingInterval = 0.25f;
+
+	/*The maximum amount of chunks loaded in one update, the closest chunks load first.*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze streaming", meta = (ClampMin = "1"))
+		int MaxChunkLoadsPerUpdate = 4;
+
+	/*Nav mesh: the inner walls are in the nav mesh and only the tiles around changed walls are rebuilt. Maze graph: the nav mesh ignores the inner walls, AI walks the paths of the maze solver.*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze navigation")
+		EMazeNavigationMode NavigationMode = EMazeNavigationMode::NAVMESH;
+
+	/*Per instance: every inner wall has a physics body. Merged chunks: the walls of a chunk are merged into one body of boxes, rebuilt on a worker. Grid queries: inner walls don't collide, use LineTraceWalls.*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze collision")
+		EMazeWallCollision WallCollision = EMazeWallCollision::PERINSTANCE;
+
+	/*Maze meshes start to fade out at this distance from the camera, 0 doesn't fade.*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze rendering", meta = (ClampMin = "0"))
+		int InstanceStartCullDistance = 15000;
+
+	/*Maze meshes further than this from the camera aren't rendered, 0 renders them at any distance.*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze rendering", meta = (ClampMin = "0"))
+		int InstanceEndCullDistance = 20000;
+
+	/*The most detailed LOD the maze meshes use, higher values skip the detailed LODs.*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze rendering", meta = (ClampMin = "0"))
+		int InstanceMinLOD = 0;
+
 	/*The wall erosion effect*/
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze FX")
 		class UNiagaraSystem* ErosionFX;
@@ -120,44 +218,134 @@ public:
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze FX")
 		bool ErodeOldWalls = true;
 
+	/*Only walls within this distance of a local player erode with fx.*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze FX", meta = (ClampMin = "0"))
+		float ErosionFXRadius = 3000.f;
+
+	/*The maximum amount of erosion fx spawned in one frame.*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze FX", meta = (ClampMin = "1"))
+		int MaxErosionFXPerFrame = 8;
+
+	/*The maximum time in milliseconds spent on spawning erosion fx in one frame.*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze FX", meta = (ClampMin = "0"))
+		float ErosionFXFrameBudgetMs = 0.5f;
+
+	/*How long in seconds removed walls wait for a player to come close before their fx is dropped.*/
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze FX", meta = (ClampMin = "0"))
+		float ErosionFXMaxDelay = 2.f;
+
+	/*The erosion fx that were culled, deferred and spawned in the last frame.*/
+	UPROPERTY(BlueprintReadOnly, VisibleInstanceOnly, Category = "Maze FX")
+		FMazeErosionStats ErosionStats;
+
 	/*If debug is drawn.*/
 	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Maze settings")
 		bool DrawDebug = false;
 
+	//The chunks copy the mesh, materials and collision of these components
 	UPROPERTY(VisibleAnywhere, Category = "Meshes")
-		UInstancedStaticMeshComponent* FloorTileISMC;
+		UHierarchicalInstancedStaticMeshComponent* FloorTileISMC;
 	UPROPERTY(VisibleAnywhere, Category = "Meshes")
-		UInstancedStaticMeshComponent* InnerWallTileISMC;
+		UHierarchicalInstancedStaticMeshComponent* InnerWallTileISMC;
 	UPROPERTY(VisibleAnywhere, Category = "Meshes")
-		UInstancedStaticMeshComponent* InnerWallTileISMC2;
-	UPROPERTY(VisibleAnywhere, Category = "Meshes")
-		UInstancedStaticMeshComponent* OuterWallTileISMC;
+		UHierarchicalInstancedStaticMeshComponent* OuterWallTileISMC;
 
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 private:
-	TMap<int, FMazeNode> MazeNodeGrid = {};
-	TArray<FMazeNodeConnection*> WallList = {};
-	TArray<FMazeNode*> MazeNodePath = {};
-	TArray<FMazeNode*> MazeNodeArray = {};
-	TArray<FMazeNodeConnection*> OldErosionWallList = {};
-	float ElapsedTimeUntilMazeChange = 0;
-
-	void SpawnMeshes(bool isSpawningFloors = true, bool isSpawningOuterWalls = true, bool IsSpawningInnerWalls = true);
-	void SpawnOuterWalls(FTransform& floorTransform, FTransform& wallTransform, FRotator& wallRotation, FVector& wallDirection, FVector& wallPos);
-	void SpawnInnerWalls(FTransform& floorTransform, FTransform& wallTransform, FRotator& wallRotation, FVector& wallDirection, FVector& wallPos);
-	void SpawnFloors(FTransform& floorTransform);
+	//The maze on screen is the front buffer, the next mazes are generated ahead of time into a ring of buffers on worker threads
+	TSharedPtr<FMazeGrid, ESPMode::ThreadSafe> FrontMaze;
+	TSharedPtr<class FMazeGenerationRing> MazeRing;
+	TSharedPtr<struct FMazeGenerationScratch, ESPMode::ThreadSafe> GenerationScratch;
+	int FrontMazeEpoch = INDEX_NONE;
+	int32 FrontMazeSeed = 0;
+	bool IsMazeChangeDue = false;
+	double MazeChangeDueTime = 0;
+	FTimerHandle MazeChangeTimerHandle;
+
+	//The maze is split in chunks that stream in around the players, the components of unloaded chunks are pooled
+	FMazeChunkGrid ChunkGrid;
+	FTimerHandle ChunkStreamingTimerHandle;
+	UPROPERTY(Transient)
+		TArray<UHierarchicalInstancedStaticMeshComponent*> ChunkComponents;
+	TArray<UHierarchicalInstancedStaticMeshComponent*> FreeFloorComponents;
+	TArray<UHierarchicalInstancedStaticMeshComponent*> FreeInnerWallComponents;
+	TArray<UHierarchicalInstancedStaticMeshComponent*> FreeOuterWallComponents;
+	TBitArray<> DirtyChunks;
+	TArray<FBox> NavigationDirtyAreas;
+	UPROPERTY(Transient)
+		TArray<class UMazeWallCollisionComponent*> CollisionComponents;
+	TArray<class UMazeWallCollisionComponent*> FreeCollisionComponents;
+	int NextCollisionBuildId = 0;
+
+	//Walls that changed between the previous and the current maze
+	FMazeWallDiff MazeWallDiff;
+
+	//The walls on screen, they only lag behind the front buffer while a wavefront is changing the walls
+	FMazeGrid DisplayedMaze;
+	TArray<int> ChangedWalls;
+	int NrOfAppliedWalls = 0;
+	TArray<int> AppliedRemovedWalls;
+	TArray<int> WallRings;
+	TArray<int> RingStarts;
+	TArray<int> SortedWalls;
+	FMazeErosionScheduler ErosionScheduler;
+
+	//What this generator added to the shared maze stats
+	int64 ReportedBytesHeld = 0;
+	int NrOfReportedChunks = 0;
+	int NrOfReportedReadyMazes = 0;
+	int NrOfReportedGeneratingMazes = 0;
+
+	void SpawnMeshes();
+	void SpawnOuterWalls(FMazeChunk& chunk);
+	void SpawnInnerWalls(FMazeChunk& chunk);
+	void SpawnFloors(FMazeChunk& chunk);
+	void LoadChunk(FMazeChunk& chunk);
+	void UnloadChunk(FMazeChunk& chunk);
+	void UnloadChunks();
+	void UpdateChunkStreaming();
+	void StartChunkStreamingTimer();
+	UHierarchicalInstancedStaticMeshComponent* AcquireChunkComponent(UHierarchicalInstancedStaticMeshComponent* templateComponent, TArray<UHierarchicalInstancedStaticMeshComponent*>& freeComponents);
+	void ApplyInstanceSettings(UHierarchicalInstancedStaticMeshComponent* component) const;
+	void ReleaseChunkComponent(UHierarchicalInstancedStaticMeshComponent* component, UHierarchicalInstancedStaticMeshComponent* templateComponent, TArray<UHierarchicalInstancedStaticMeshComponent*>& freeComponents);
+	bool IsStreamingChunks() const;
+	/*The view points of the local players, with the pawns of the remote players too if they are asked for.*/
+	void GetPlayerLocations(TArray<FVector>& outLocations, bool includeRemotePlayers = false) const;
+	/*Applies the changed walls in order until the budget runs out, a budget of 0 applies all of them.*/
+	void UpdateInnerWalls(float frameBudgetMs);
+	void SortChangedWalls();
+	void FinishWallChanges();
+	FORCEINLINE bool IsChangingWalls() const { return NrOfAppliedWalls < ChangedWalls.Num(); }
+	void UpdateChunkNavigation(FMazeChunk& chunk);
+	void UpdateChunkCollision(FMazeChunk& chunk);
+	void BuildWallCollision();
+	void OnWallCollisionBuilt(const TArray<struct FMazeChunkCollisionBuild>& builds);
+	void SpawnErosionFX(const TArray<int>& removedWalls, bool isNewChange);
+	void UpdateErosionFX();
 	void DrawDebugMazeGrid();
-
-	void GenerateDFSMazeAsync();
-	void GenerateDFSMaze();
-	void GenerateKruskalsMazeAsync();
-	void UpdateChangeMaze(float delta);
+	void UpdateMemoryStats();
+	void UpdateMazeSolver();
+
+	/*Fills the ring with requests for the next epochs, as long as there are free slots and workers.*/
+	void RequestNextMazes();
+	void UpdateGenerationStats();
+	/*The settings for the maze of an epoch, a mutation without the maze of the epoch before replays the mutations since the last keyframe.*/
+	struct FMazeGenerationSettings GetGenerationSettings(int32 epoch, bool hasPreviousMaze) const;
+	/*The last epoch at or before this epoch of which the maze is generated and not mutated, the first epoch without keyframes.*/
+	int32 GetMutationKeyframe(int32 epoch) const;
+	UFUNCTION()
+		void OnRep_MazeEpoch();
+	void OnNextMazeGenerated();
+	void OnMazeChangeTimer();
+	void StartMazeChangeTimer();
+	void ChangeMaze();
 
 public:
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
 
-};
+};
\ No newline at end of file
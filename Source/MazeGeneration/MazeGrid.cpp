@@ -0,0 +1,146 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MazeGrid.h"
+#include "MazeGeneration.h"
+
+FMazeGrid::FMazeGrid()
+	:MazeStartPosition()
+	, NrOfMazeColumns(0)
+	, NrOfMazeRows(0)
+	, MazeTileSize(0)
+	, NrOfWordsPerRow(0)
+{
+}
+
+void FMazeGrid::Init(FVector mazeStartPosition, int nrOfMazeColumns, int nrOfMazeRows, float mazeTileSize)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MazeGridInit);
+	TRACE_CPUPROFILER_EVENT_SCOPE(FMazeGrid::Init);
+
+	MazeStartPosition = mazeStartPosition;
+	NrOfMazeColumns = FMath::Max(nrOfMazeColumns, 0);
+	NrOfMazeRows = FMath::Max(nrOfMazeRows, 0);
+	MazeTileSize = mazeTileSize;
+	NrOfWordsPerRow = (NrOfMazeColumns + 63) / 64;
+
+	ResetWalls();
+	ResetVisited();
+}
+
+void FMazeGrid::ResetWalls()
+{
+	GetInnerWallMask(Walls);
+}
+
+void FMazeGrid::GetInnerWallMask(TArray<uint64>& outWalls) const
+{
+	outWalls.SetNumUninitialized(NrOfWallPlanes * NrOfMazeRows * NrOfWordsPerRow);
+
+	//A wall exists between every pair of adjacent cells, the last column has no east wall and the last row no south wall
+	for (int row = 0; row < NrOfMazeRows; row++)
+	{
+		for (int word = 0; word < NrOfWordsPerRow; word++)
+		{
+			const int firstCol = word * 64;
+			const int nrOfCols = FMath::Min(64, NrOfMazeColumns - firstCol);
+			const uint64 colMask = nrOfCols == 64 ? ~0ull : (1ull << nrOfCols) - 1;
+			const uint64 eastMask = firstCol + nrOfCols == NrOfMazeColumns ? colMask >> 1 : colMask;
+			const uint64 southMask = row + 1 < NrOfMazeRows ? colMask : 0;
+
+			outWalls[GetWallIndex(row, firstCol, East) >> 6] = eastMask;
+			outWalls[GetWallIndex(row, firstCol, South) >> 6] = southMask;
+		}
+	}
+}
+
+void FMazeGrid::ResetVisited()
+{
+	Visited.Init(false, GetNrOfCells());
+}
+
+int FMazeGrid::GetNeighbors(int cellIdx, int(&outCells)[NrOfNeighbors], int(&outWalls)[NrOfNeighbors]) const
+{
+	const int row = cellIdx / NrOfMazeColumns;
+	const int col = cellIdx % NrOfMazeColumns;
+	const FMazeTopologyEdge* edges = FMazeSquareTopology::GetEdges(row);
+	int nrOfNeighbors = 0;
+
+	//East, south, west, north. The table is known at compile time, so this unrolls
+	for (int i = 0; i < NrOfNeighbors; i++)
+	{
+		const FMazeTopologyEdge& edge = edges[i];
+		const int neighborRow = row + edge.RowOffset;
+		const int neighborCol = col + edge.ColOffset;
+		if ((uint32)neighborRow >= (uint32)NrOfMazeRows || (uint32)neighborCol >= (uint32)NrOfMazeColumns)
+			continue;
+
+		outCells[nrOfNeighbors] = GetCellIndex(neighborRow, neighborCol);
+		outWalls[nrOfNeighbors++] = edge.IsOwnedByNeighbor
+			? GetWallIndex(neighborRow, neighborCol, (EWallPlane)edge.Plane)
+			: GetWallIndex(row, col, (EWallPlane)edge.Plane);
+	}
+	return nrOfNeighbors;
+}
+
+bool FMazeGrid::GetWallCells(int wallIdx, int& outFromCellIdx, int& outToCellIdx) const
+{
+	int row{}, col{};
+	EWallPlane plane{};
+	if (!GetWallCoordinates(wallIdx, row, col, plane))
+		return false;
+
+	outFromCellIdx = GetCellIndex(row, col);
+	outToCellIdx = plane == East ? outFromCellIdx + 1 : outFromCellIdx + NrOfMazeColumns;
+	return true;
+}
+
+bool FMazeGrid::GetWallCoordinates(int wallIdx, int& outRow, int& outCol, EWallPlane& outPlane) const
+{
+	const int nrOfBitsPerRow = NrOfWordsPerRow * 64;
+	const int nrOfBitsPerPlane = NrOfMazeRows * nrOfBitsPerRow;
+	if (wallIdx < 0 || nrOfBitsPerPlane == 0 || wallIdx >= NrOfWallPlanes * nrOfBitsPerPlane)
+		return false;
+
+	outPlane = wallIdx < nrOfBitsPerPlane ? East : South;
+	outRow = (wallIdx % nrOfBitsPerPlane) / nrOfBitsPerRow;
+	outCol = wallIdx % nrOfBitsPerRow;
+
+	if (outPlane == East)
+		return outCol + 1 < NrOfMazeColumns;
+	return outCol < NrOfMazeColumns && outRow + 1 < NrOfMazeRows;
+}
+
+FVector FMazeGrid::GetCellPosition(int cellIdx) const
+{
+	FVector position = MazeStartPosition;
+	position.X += MazeTileSize * (cellIdx % NrOfMazeColumns) - MazeTileSize / 2;
+	position.Y -= MazeTileSize * (cellIdx / NrOfMazeColumns) + MazeTileSize / 2;
+	return position;
+}
+
+bool FMazeGrid::GetCellCoordinates(const FVector& location, int& outRow, int& outCol) const
+{
+	if (MazeTileSize <= 0)
+		return false;
+
+	//Cell centers are half a tile before the column and after the row
+	outCol = FMath::FloorToInt((location.X - MazeStartPosition.X) / MazeTileSize) + 1;
+	outRow = FMath::FloorToInt((MazeStartPosition.Y - location.Y) / MazeTileSize);
+	return 0 <= outCol && outCol < NrOfMazeColumns && 0 <= outRow && outRow < NrOfMazeRows;
+}
+
+FVector FMazeGrid::GetWallPosition(int wallIdx) const
+{
+	int fromCellIdx{}, toCellIdx{};
+	if (!GetWallCells(wallIdx, fromCellIdx, toCellIdx))
+		return MazeStartPosition;
+
+	return GetCellPosition(fromCellIdx) + GetWallDirection(wallIdx) * (MazeTileSize / 2);
+}
+
+FVector FMazeGrid::GetWallDirection(int wallIdx) const
+{
+	//Rows go down along the Y-axis
+	return GetWallPlane(wallIdx) == East ? FVector{ 1, 0, 0 } : FVector{ 0, -1, 0 };
+}
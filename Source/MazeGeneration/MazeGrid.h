@@ -0,0 +1,105 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MazeTopology.h"
+
+/**
+ * Structure-of-arrays maze grid.
+ * Every cell owns the wall to its east (column + 1) and the wall to its south (row + 1), both stored as a single bit.
+ * Each row of a wall plane is padded to whole 64 bit words, so a wall index is also the bit index in the Walls array.
+ * Walls on the border of the grid are never set, those are the outer walls.
+ */
+struct MAZEGENERATION_API FMazeGrid
+{
+	enum EWallPlane : int
+	{
+		East = 0,
+		South = 1,
+		NrOfWallPlanes = 2
+	};
+
+	//The planes and the neighbor order come from the square topology, the generator kernels are shared with the other topologies
+	static constexpr int NrOfNeighbors = FMazeSquareTopology::NrOfNeighbors;
+	static_assert(FMazeSquareTopology::NrOfWallPlanes == NrOfWallPlanes, "The wall planes have to match the square topology");
+
+	FMazeGrid();
+
+	/*Sizes the grid, all inner walls are closed and no cell is visited.*/
+	void Init(FVector mazeStartPosition, int nrOfMazeColumns, int nrOfMazeRows, float mazeTileSize);
+	void ResetWalls();
+	void ResetVisited();
+
+	FORCEINLINE int GetNrOfCells() const { return NrOfMazeColumns * NrOfMazeRows; }
+	FORCEINLINE int GetNrOfWallBits() const { return Walls.Num() * 64; }
+	FORCEINLINE SIZE_T GetAllocatedSize() const { return Walls.GetAllocatedSize() + Visited.GetAllocatedSize(); }
+	FORCEINLINE int GetCellIndex(int row, int col) const { return row * NrOfMazeColumns + col; }
+
+	FORCEINLINE int GetWallIndex(int row, int col, EWallPlane plane) const
+	{
+		return (plane * NrOfMazeRows + row) * NrOfWordsPerRow * 64 + col;
+	}
+	FORCEINLINE int GetWallIndex(int cellIdx, EWallPlane plane) const
+	{
+		return GetWallIndex(cellIdx / NrOfMazeColumns, cellIdx % NrOfMazeColumns, plane);
+	}
+
+	FORCEINLINE bool IsWall(int wallIdx) const { return (Walls[wallIdx >> 6] >> (wallIdx & 63)) & 1; }
+	FORCEINLINE void SetWall(int wallIdx) { Walls[wallIdx >> 6] |= 1ull << (wallIdx & 63); }
+	FORCEINLINE void RemoveWall(int wallIdx) { Walls[wallIdx >> 6] &= ~(1ull << (wallIdx & 63)); }
+
+	FORCEINLINE bool IsVisited(int cellIdx) const { return Visited[cellIdx]; }
+	FORCEINLINE void SetVisited(int cellIdx) { Visited[cellIdx] = true; }
+
+	/*Fills the adjacent cells and the walls in between, returns the amount of neighbors (max 4).*/
+	int GetNeighbors(int cellIdx, int(&outCells)[NrOfNeighbors], int(&outWalls)[NrOfNeighbors]) const;
+
+	/*Gets the two cells a wall separates, returns false if the index is not an inner wall of the grid.*/
+	bool GetWallCells(int wallIdx, int& outFromCellIdx, int& outToCellIdx) const;
+	/*Gets the row and column of the cell that owns a wall, returns false if the index is not an inner wall of the grid.*/
+	bool GetWallCoordinates(int wallIdx, int& outRow, int& outCol, EWallPlane& outPlane) const;
+
+	FVector GetCellPosition(int cellIdx) const;
+	/*Gets the row and column of the cell a world location is in, returns false if it is outside the grid.*/
+	bool GetCellCoordinates(const FVector& location, int& outRow, int& outCol) const;
+	FVector GetWallPosition(int wallIdx) const;
+	FVector GetWallDirection(int wallIdx) const;
+	FORCEINLINE EWallPlane GetWallPlane(int wallIdx) const
+	{
+		return wallIdx < NrOfMazeRows * NrOfWordsPerRow * 64 ? East : South;
+	}
+
+	/*Fills the wall bits of every possible inner wall, this is the state after ResetWalls.*/
+	void GetInnerWallMask(TArray<uint64>& outWalls) const;
+
+	/*Calls func(wallIdx) for every wall that is set, in increasing wall index order.*/
+	template<typename FunctionType>
+	void ForEachWall(FunctionType&& func) const
+	{
+		ForEachSetBit(Walls, func);
+	}
+
+	template<typename FunctionType>
+	static void ForEachSetBit(const TArray<uint64>& words, FunctionType&& func)
+	{
+		for (int wordIdx = 0; wordIdx < words.Num(); wordIdx++)
+		{
+			uint64 word = words[wordIdx];
+			while (word)
+			{
+				func(wordIdx * 64 + (int)FMath::CountTrailingZeros64(word));
+				word &= word - 1;
+			}
+		}
+	}
+
+	FVector MazeStartPosition;
+	int NrOfMazeColumns;
+	int NrOfMazeRows;
+	float MazeTileSize;
+	int NrOfWordsPerRow;
+
+	TArray<uint64> Walls;
+	TBitArray<> Visited;
+};
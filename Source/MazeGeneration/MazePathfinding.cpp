@@ -0,0 +1,346 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MazePathfinding.h"
+#include "MazeGrid.h"
+#include "MazeWallDiff.h"
+#include "Algo/Reverse.h"
+#include "HAL/ThreadSingleton.h"
+
+namespace
+{
+	/*Fills the adjacent cells without a wall in between, returns the amount (max 4).*/
+	int GetOpenNeighbors(const FMazeGrid& mazeGrid, int cellIdx, int(&outCells)[4])
+	{
+		int adjacentCells[4]{}, adjacentWalls[4]{};
+		const int nrOfAdjacentCells = mazeGrid.GetNeighbors(cellIdx, adjacentCells, adjacentWalls);
+		int nrOfOpenCells = 0;
+		for (int i = 0; i < nrOfAdjacentCells; i++)
+		{
+			if (!mazeGrid.IsWall(adjacentWalls[i]))
+				outCells[nrOfOpenCells++] = adjacentCells[i];
+		}
+		return nrOfOpenCells;
+	}
+
+	bool IsValidCell(const FMazeGrid& mazeGrid, int cellIdx)
+	{
+		return 0 <= cellIdx && cellIdx < mazeGrid.GetNrOfCells();
+	}
+
+	/*Walks the parents back from the goal.*/
+	void GetPath(const TArray<int>& parents, int startCellIdx, int goalCellIdx, TArray<int>& outCells)
+	{
+		for (int cellIdx = goalCellIdx; cellIdx != startCellIdx; cellIdx = parents[cellIdx])
+		{
+			outCells.Add(cellIdx);
+		}
+		outCells.Add(startCellIdx);
+		Algo::Reverse(outCells);
+	}
+
+	struct FOpenCellPredicate
+	{
+		FORCEINLINE bool operator()(const TPair<int32, int>& a, const TPair<int32, int>& b) const { return a.Key < b.Key; }
+	};
+
+	/**
+	 * Memory the searches of one thread keep between queries, it only grows with the biggest maze searched on that thread.
+	 * The stamps mark the cells a search visited without clearing them, so a query only touches the cells it visits.
+	 */
+	struct FMazePathScratch : public TThreadSingleton<FMazePathScratch>
+	{
+		/*Starts a new search on a grid of this size, parents and costs are only valid for cells with the returned stamp.*/
+		uint32 BeginSearch(int nrOfCells)
+		{
+			if (VisitStamps.Num() < nrOfCells)
+			{
+				VisitStamps.SetNumZeroed(nrOfCells, false);
+				Parents.SetNumUninitialized(nrOfCells, false);
+				Costs.SetNumUninitialized(nrOfCells, false);
+			}
+
+			if (++VisitStamp == 0)
+			{
+				FMemory::Memzero(VisitStamps.GetData(), VisitStamps.Num() * sizeof(uint32));
+				VisitStamp = 1;
+			}
+			return VisitStamp;
+		}
+
+		TArray<uint32> VisitStamps;
+		uint32 VisitStamp = 0;
+		TArray<int> Parents;
+		TArray<int32> Costs;
+		TArray<int> CellQueue;
+		TArray<TPair<int32, int>> OpenCells;
+
+		//Repairing distances
+		TArray<int> LostCells;
+		TArray<int> InvalidCells;
+	};
+}
+
+bool FMazePathfinding::FindPathBFS(const FMazeGrid& mazeGrid, int startCellIdx, int goalCellIdx, TArray<int>& outCells)
+{
+	outCells.Reset();
+	if (!IsValidCell(mazeGrid, startCellIdx) || !IsValidCell(mazeGrid, goalCellIdx))
+		return false;
+
+	FMazePathScratch& scratch = FMazePathScratch::Get();
+	const uint32 visitStamp = scratch.BeginSearch(mazeGrid.GetNrOfCells());
+	TArray<uint32>& visitStamps = scratch.VisitStamps;
+	TArray<int>& parents = scratch.Parents;
+	TArray<int>& queue = scratch.CellQueue;
+	queue.Reset();
+	queue.Add(startCellIdx);
+	visitStamps[startCellIdx] = visitStamp;
+	parents[startCellIdx] = startCellIdx;
+
+	int openCells[4]{};
+	for (int head = 0; head < queue.Num() && visitStamps[goalCellIdx] != visitStamp; head++)
+	{
+		const int cellIdx = queue[head];
+		const int nrOfOpenCells = GetOpenNeighbors(mazeGrid, cellIdx, openCells);
+		for (int i = 0; i < nrOfOpenCells; i++)
+		{
+			if (visitStamps[openCells[i]] == visitStamp)
+				continue;
+
+			visitStamps[openCells[i]] = visitStamp;
+			parents[openCells[i]] = cellIdx;
+			queue.Add(openCells[i]);
+		}
+	}
+
+	if (visitStamps[goalCellIdx] != visitStamp)
+		return false;
+
+	GetPath(parents, startCellIdx, goalCellIdx, outCells);
+	return true;
+}
+
+bool FMazePathfinding::FindPathAStar(const FMazeGrid& mazeGrid, int startCellIdx, int goalCellIdx, TArray<int>& outCells)
+{
+	outCells.Reset();
+	if (!IsValidCell(mazeGrid, startCellIdx) || !IsValidCell(mazeGrid, goalCellIdx))
+		return false;
+
+	const int goalRow = goalCellIdx / mazeGrid.NrOfMazeColumns;
+	const int goalCol = goalCellIdx % mazeGrid.NrOfMazeColumns;
+	auto getHeuristic = [&](int cellIdx)
+	{
+		return FMath::Abs(cellIdx / mazeGrid.NrOfMazeColumns - goalRow) + FMath::Abs(cellIdx % mazeGrid.NrOfMazeColumns - goalCol);
+	};
+
+	//A cell without the stamp of this search hasn't been reached yet, its cost is unreachable
+	FMazePathScratch& scratch = FMazePathScratch::Get();
+	const uint32 visitStamp = scratch.BeginSearch(mazeGrid.GetNrOfCells());
+	TArray<uint32>& visitStamps = scratch.VisitStamps;
+	TArray<int32>& costs = scratch.Costs;
+	TArray<int>& parents = scratch.Parents;
+	auto getCost = [&](int cellIdx)
+	{
+		return visitStamps[cellIdx] == visitStamp ? costs[cellIdx] : Unreachable;
+	};
+
+	//Open cells are sorted on cost + heuristic
+	TArray<TPair<int32, int>>& openCells = scratch.OpenCells;
+	openCells.Reset();
+	visitStamps[startCellIdx] = visitStamp;
+	costs[startCellIdx] = 0;
+	parents[startCellIdx] = startCellIdx;
+	openCells.HeapPush(TPair<int32, int>(getHeuristic(startCellIdx), startCellIdx), FOpenCellPredicate());
+
+	int adjacentCells[4]{};
+	while (openCells.Num() > 0)
+	{
+		TPair<int32, int> openCell{};
+		openCells.HeapPop(openCell, FOpenCellPredicate(), false);
+		const int cellIdx = openCell.Value;
+		if (cellIdx == goalCellIdx)
+			break;
+
+		//A cell can be in the heap more than once, only the cheapest entry is expanded
+		const int32 cost = costs[cellIdx];
+		if (openCell.Key > cost + getHeuristic(cellIdx))
+			continue;
+
+		const int nrOfOpenCells = GetOpenNeighbors(mazeGrid, cellIdx, adjacentCells);
+		for (int i = 0; i < nrOfOpenCells; i++)
+		{
+			const int adjacentCellIdx = adjacentCells[i];
+			if (cost + 1 >= getCost(adjacentCellIdx))
+				continue;
+
+			visitStamps[adjacentCellIdx] = visitStamp;
+			costs[adjacentCellIdx] = cost + 1;
+			parents[adjacentCellIdx] = cellIdx;
+			openCells.HeapPush(TPair<int32, int>(cost + 1 + getHeuristic(adjacentCellIdx), adjacentCellIdx), FOpenCellPredicate());
+		}
+	}
+
+	if (getCost(goalCellIdx) == Unreachable)
+		return false;
+
+	GetPath(parents, startCellIdx, goalCellIdx, outCells);
+	return true;
+}
+
+void FMazePathfinding::ComputeDistances(const FMazeGrid& mazeGrid, const TArray<int>& goalCells, TArray<int32>& outDistances)
+{
+	outDistances.Init(Unreachable, mazeGrid.GetNrOfCells());
+
+	//One breadth-first search from all goals at once
+	TArray<int>& queue = FMazePathScratch::Get().CellQueue;
+	queue.Reset();
+	for (int goalCellIdx : goalCells)
+	{
+		if (IsValidCell(mazeGrid, goalCellIdx) && outDistances[goalCellIdx] != 0)
+		{
+			outDistances[goalCellIdx] = 0;
+			queue.Add(goalCellIdx);
+		}
+	}
+
+	int openCells[4]{};
+	for (int head = 0; head < queue.Num(); head++)
+	{
+		const int cellIdx = queue[head];
+		const int nrOfOpenCells = GetOpenNeighbors(mazeGrid, cellIdx, openCells);
+		for (int i = 0; i < nrOfOpenCells; i++)
+		{
+			if (outDistances[openCells[i]] != Unreachable)
+				continue;
+
+			outDistances[openCells[i]] = outDistances[cellIdx] + 1;
+			queue.Add(openCells[i]);
+		}
+	}
+}
+
+void FMazePathfinding::UpdateDistances(const FMazeGrid& mazeGrid, const FMazeWallDiff& wallDiff, const TArray<int>& goalCells, TArray<int32>& inOutDistances)
+{
+	if (inOutDistances.Num() != mazeGrid.GetNrOfCells())
+	{
+		ComputeDistances(mazeGrid, goalCells, inOutDistances);
+		return;
+	}
+
+	//A new wall can only make paths longer, a cell loses its distance if no open neighbor is one step closer anymore
+	FMazePathScratch& scratch = FMazePathScratch::Get();
+	TArray<int>& lostCells = scratch.LostCells;
+	lostCells.Reset();
+	for (int wallIdx : wallDiff.AddedWalls)
+	{
+		int fromCellIdx{}, toCellIdx{};
+		if (mazeGrid.GetWallCells(wallIdx, fromCellIdx, toCellIdx))
+		{
+			lostCells.Add(fromCellIdx);
+			lostCells.Add(toCellIdx);
+		}
+	}
+
+	int openCells[4]{};
+	TArray<int>& invalidCells = scratch.InvalidCells;
+	invalidCells.Reset();
+	for (int idx = 0; idx < lostCells.Num(); idx++)
+	{
+		const int cellIdx = lostCells[idx];
+		const int32 distance = inOutDistances[cellIdx];
+		if (distance == 0 || distance == Unreachable)
+			continue;
+
+		bool isSupported = false;
+		const int nrOfOpenCells = GetOpenNeighbors(mazeGrid, cellIdx, openCells);
+		for (int i = 0; i < nrOfOpenCells && !isSupported; i++)
+		{
+			isSupported = inOutDistances[openCells[i]] == distance - 1;
+		}
+		if (isSupported)
+			continue;
+
+		//The cells that were one step further through this cell have to be checked again
+		inOutDistances[cellIdx] = Unreachable;
+		invalidCells.Add(cellIdx);
+		for (int i = 0; i < nrOfOpenCells; i++)
+		{
+			if (inOutDistances[openCells[i]] == distance + 1)
+				lostCells.Add(openCells[i]);
+		}
+	}
+
+	//Invalid cells start from their closest valid neighbor, openings start a shortcut from the closer side
+	TArray<TPair<int32, int>>& seeds = scratch.OpenCells;
+	seeds.Reset();
+	for (int cellIdx : invalidCells)
+	{
+		int32 distance = Unreachable;
+		const int nrOfOpenCells = GetOpenNeighbors(mazeGrid, cellIdx, openCells);
+		for (int i = 0; i < nrOfOpenCells; i++)
+		{
+			if (inOutDistances[openCells[i]] != Unreachable)
+				distance = FMath::Min(distance, inOutDistances[openCells[i]] + 1);
+		}
+		if (distance != Unreachable)
+			seeds.Emplace(distance, cellIdx);
+	}
+	for (int wallIdx : wallDiff.RemovedWalls)
+	{
+		int fromCellIdx{}, toCellIdx{};
+		if (!mazeGrid.GetWallCells(wallIdx, fromCellIdx, toCellIdx))
+			continue;
+
+		const int32 fromDistance = inOutDistances[fromCellIdx];
+		const int32 toDistance = inOutDistances[toCellIdx];
+		if (fromDistance != Unreachable && fromDistance + 1 < toDistance)
+			seeds.Emplace(fromDistance + 1, toCellIdx);
+		else if (toDistance != Unreachable && toDistance + 1 < fromDistance)
+			seeds.Emplace(toDistance + 1, fromCellIdx);
+	}
+
+	PropagateDistances(mazeGrid, seeds, inOutDistances);
+}
+
+void FMazePathfinding::PropagateDistances(const FMazeGrid& mazeGrid, TArray<TPair<int32, int>>& openCells, TArray<int32>& inOutDistances)
+{
+	//Dijkstra from the seeds, a cell only changes if its distance gets shorter
+	openCells.Heapify(FOpenCellPredicate());
+	int adjacentCells[4]{};
+	while (openCells.Num() > 0)
+	{
+		TPair<int32, int> openCell{};
+		openCells.HeapPop(openCell, FOpenCellPredicate(), false);
+		const int32 distance = openCell.Key;
+		const int cellIdx = openCell.Value;
+		if (distance >= inOutDistances[cellIdx])
+			continue;
+
+		inOutDistances[cellIdx] = distance;
+		const int nrOfOpenCells = GetOpenNeighbors(mazeGrid, cellIdx, adjacentCells);
+		for (int i = 0; i < nrOfOpenCells; i++)
+		{
+			if (distance + 1 < inOutDistances[adjacentCells[i]])
+				openCells.HeapPush(TPair<int32, int>(distance + 1, adjacentCells[i]), FOpenCellPredicate());
+		}
+	}
+}
+
+int FMazePathfinding::GetNextCell(const FMazeGrid& mazeGrid, const TArray<int32>& distances, int cellIdx)
+{
+	if (!IsValidCell(mazeGrid, cellIdx) || distances.Num() != mazeGrid.GetNrOfCells())
+		return INDEX_NONE;
+
+	const int32 distance = distances[cellIdx];
+	if (distance == 0 || distance == Unreachable)
+		return INDEX_NONE;
+
+	int openCells[4]{};
+	const int nrOfOpenCells = GetOpenNeighbors(mazeGrid, cellIdx, openCells);
+	for (int i = 0; i < nrOfOpenCells; i++)
+	{
+		if (distances[openCells[i]] == distance - 1)
+			return openCells[i];
+	}
+	return INDEX_NONE;
+}
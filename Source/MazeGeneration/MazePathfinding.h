@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FMazeGrid;
+struct FMazeWallDiff;
+
+/**
+ * Searches directly on the wall bits of a maze grid, two cells are connected if the wall between them isn't set.
+ * Every function only reads the grid, so it can run on any thread on a grid nobody writes to.
+ */
+struct MAZEGENERATION_API FMazePathfinding
+{
+	/*Distance of a cell that can't reach a goal.*/
+	static constexpr int32 Unreachable = MAX_int32;
+
+	/*Breadth-first search, fills the cells from start to goal. Returns false if the goal can't be reached.*/
+	static bool FindPathBFS(const FMazeGrid& mazeGrid, int startCellIdx, int goalCellIdx, TArray<int>& outCells);
+	/*A* with the manhattan distance, visits fewer cells than BFS when the path is close to straight.*/
+	static bool FindPathAStar(const FMazeGrid& mazeGrid, int startCellIdx, int goalCellIdx, TArray<int>& outCells);
+
+	/*Distance of every cell to the closest goal, in cells.*/
+	static void ComputeDistances(const FMazeGrid& mazeGrid, const TArray<int>& goalCells, TArray<int32>& outDistances);
+
+	/**
+	 * Repairs the distances of the previous maze after the walls in the diff changed.
+	 * Only the cells whose shortest path changed are visited, the result is the same as ComputeDistances.
+	 */
+	static void UpdateDistances(const FMazeGrid& mazeGrid, const FMazeWallDiff& wallDiff, const TArray<int>& goalCells, TArray<int32>& inOutDistances);
+
+	/*The adjacent cell that is one step closer to a goal, INDEX_NONE on a goal or an unreachable cell.*/
+	static int GetNextCell(const FMazeGrid& mazeGrid, const TArray<int32>& distances, int cellIdx);
+
+private:
+	static void PropagateDistances(const FMazeGrid& mazeGrid, TArray<TPair<int32, int>>& openCells, TArray<int32>& inOutDistances);
+};
@@ -0,0 +1,217 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MazeSolver.h"
+#include "MazePathfinding.h"
+#include "MazeGeneration.h"
+#include "Async/Async.h"
+
+const FMazeDistanceField* FMazeSolverSnapshot::FindDistanceField(int fieldId) const
+{
+	return DistanceFields.FindByPredicate([fieldId](const FMazeDistanceField& field) { return field.Id == fieldId; });
+}
+
+bool FMazeSolverSnapshot::FindPath(int startCellIdx, int goalCellIdx, EMazePathAlgorithm algorithm, TArray<int>& outCells) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_MazeFindPath);
+	TRACE_CPUPROFILER_EVENT_SCOPE(FMazeSolverSnapshot::FindPath);
+
+	if (algorithm == EMazePathAlgorithm::ASTAR)
+		return FMazePathfinding::FindPathAStar(MazeGrid, startCellIdx, goalCellIdx, outCells);
+	return FMazePathfinding::FindPathBFS(MazeGrid, startCellIdx, goalCellIdx, outCells);
+}
+
+int FMazeSolverSnapshot::GetNextCell(int fieldId, int cellIdx) const
+{
+	const FMazeDistanceField* field = FindDistanceField(fieldId);
+	return field ? FMazePathfinding::GetNextCell(MazeGrid, field->Distances, cellIdx) : INDEX_NONE;
+}
+
+FMazeSolverSnapshotRef::FMazeSolverSnapshotRef(const FMazeSolverSnapshot* snapshot, TAtomic<int>* nrOfReaders)
+	:Snapshot(snapshot)
+	, NrOfReaders(nrOfReaders)
+{
+}
+
+FMazeSolverSnapshotRef::FMazeSolverSnapshotRef(FMazeSolverSnapshotRef&& other)
+	:Snapshot(other.Snapshot)
+	, NrOfReaders(other.NrOfReaders)
+{
+	other.Snapshot = nullptr;
+	other.NrOfReaders = nullptr;
+}
+
+FMazeSolverSnapshotRef& FMazeSolverSnapshotRef::operator=(FMazeSolverSnapshotRef&& other)
+{
+	if (this != &other)
+	{
+		Release();
+		Swap(Snapshot, other.Snapshot);
+		Swap(NrOfReaders, other.NrOfReaders);
+	}
+	return *this;
+}
+
+FMazeSolverSnapshotRef::~FMazeSolverSnapshotRef()
+{
+	Release();
+}
+
+void FMazeSolverSnapshotRef::Release()
+{
+	if (NrOfReaders)
+		--(*NrOfReaders);
+
+	Snapshot = nullptr;
+	NrOfReaders = nullptr;
+}
+
+void FMazeSolver::SetMaze(const FMazeGrid& mazeGrid, int epoch)
+{
+	LatestMaze = mazeGrid;
+	LatestEpoch = epoch;
+	RequestUpdate();
+}
+
+int FMazeSolver::AddDistanceField(const TArray<FVector>& goalLocations)
+{
+	FMazeDistanceField& field = DistanceFieldGoals.AddDefaulted_GetRef();
+	field.Id = NextDistanceFieldId++;
+	field.GoalLocations = goalLocations;
+	RequestUpdate();
+	return field.Id;
+}
+
+void FMazeSolver::RemoveDistanceField(int fieldId)
+{
+	DistanceFieldGoals.RemoveAll([fieldId](const FMazeDistanceField& field) { return field.Id == fieldId; });
+	RequestUpdate();
+}
+
+FMazeSolverSnapshotRef FMazeSolver::AcquireSnapshot() const
+{
+	//Register as a reader of the published slot, try again if another slot was published in the meantime
+	while (true)
+	{
+		const int slotIdx = PublishedSlotIdx.Load();
+		if (slotIdx == INDEX_NONE)
+			return FMazeSolverSnapshotRef();
+
+		const FSnapshotSlot& slot = Slots[slotIdx];
+		++slot.NrOfReaders;
+		if (PublishedSlotIdx.Load() == slotIdx)
+			return FMazeSolverSnapshotRef(&slot.Snapshot, &slot.NrOfReaders);
+		--slot.NrOfReaders;
+	}
+}
+
+void FMazeSolver::RequestUpdate()
+{
+	if (LatestEpoch == INDEX_NONE)
+		return;
+
+	//Changes during an update are picked up by the next one
+	if (IsUpdating)
+	{
+		IsUpdatePending = true;
+		return;
+	}
+	StartUpdate();
+}
+
+void FMazeSolver::StartUpdate()
+{
+	//The new snapshot is written into a slot that isn't published and has no readers
+	const int publishedSlotIdx = PublishedSlotIdx.Load();
+	int slotIdx = INDEX_NONE;
+	for (int idx = 0; idx < NrOfSnapshotSlots && slotIdx == INDEX_NONE; idx++)
+	{
+		if (idx != publishedSlotIdx && Slots[idx].NrOfReaders.Load() == 0)
+			slotIdx = idx;
+	}
+
+	//Readers hold every slot, the update waits for the next change
+	if (slotIdx == INDEX_NONE)
+	{
+		IsUpdatePending = true;
+		return;
+	}
+
+	FMazeSolverSnapshot& snapshot = Slots[slotIdx].Snapshot;
+	snapshot.Epoch = LatestEpoch;
+	snapshot.MazeGrid = LatestMaze;
+	snapshot.DistanceFields.SetNum(DistanceFieldGoals.Num());
+	for (int fieldIdx = 0; fieldIdx < DistanceFieldGoals.Num(); fieldIdx++)
+	{
+		snapshot.DistanceFields[fieldIdx].Id = DistanceFieldGoals[fieldIdx].Id;
+		snapshot.DistanceFields[fieldIdx].GoalLocations = DistanceFieldGoals[fieldIdx].GoalLocations;
+	}
+
+	IsUpdating = true;
+	IsUpdatePending = false;
+	TWeakPtr<FMazeSolver, ESPMode::ThreadSafe> weakThis = AsShared();
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask, [weakThis, slotIdx, publishedSlotIdx]()
+	{
+		if (TSharedPtr<FMazeSolver, ESPMode::ThreadSafe> mazeSolver = weakThis.Pin())
+			mazeSolver->UpdateSnapshot(slotIdx, publishedSlotIdx);
+
+		AsyncTask(ENamedThreads::GameThread, [weakThis]()
+		{
+			if (TSharedPtr<FMazeSolver, ESPMode::ThreadSafe> mazeSolver = weakThis.Pin())
+				mazeSolver->OnUpdateFinished();
+		});
+	});
+}
+
+void FMazeSolver::UpdateSnapshot(int slotIdx, int previousSlotIdx)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MazeSolverUpdate);
+	TRACE_CPUPROFILER_EVENT_SCOPE(FMazeSolver::UpdateSnapshot);
+
+	//The published snapshot isn't reused before this update is done
+	FMazeSolverSnapshot& snapshot = Slots[slotIdx].Snapshot;
+	const FMazeSolverSnapshot* previousSnapshot = previousSlotIdx != INDEX_NONE ? &Slots[previousSlotIdx].Snapshot : nullptr;
+	const FMazeGrid& mazeGrid = snapshot.MazeGrid;
+
+	//Distances can only be repaired between mazes of the same dimensions, when most walls changed a new search is cheaper
+	bool isRepairable = previousSnapshot
+		&& previousSnapshot->MazeGrid.NrOfMazeColumns == mazeGrid.NrOfMazeColumns
+		&& previousSnapshot->MazeGrid.NrOfMazeRows == mazeGrid.NrOfMazeRows;
+	if (isRepairable)
+	{
+		WallDiff.Compute(previousSnapshot->MazeGrid.Walls, mazeGrid.Walls);
+		isRepairable = WallDiff.GetNrOfChangedWalls() * 8 < mazeGrid.GetNrOfCells();
+	}
+
+	for (FMazeDistanceField& field : snapshot.DistanceFields)
+	{
+		field.GoalCells.Reset();
+		for (const FVector& goalLocation : field.GoalLocations)
+		{
+			int row{}, col{};
+			if (mazeGrid.GetCellCoordinates(goalLocation, row, col))
+				field.GoalCells.Add(mazeGrid.GetCellIndex(row, col));
+		}
+
+		const FMazeDistanceField* previousField = previousSnapshot ? previousSnapshot->FindDistanceField(field.Id) : nullptr;
+		if (isRepairable && previousField && previousField->GoalCells == field.GoalCells)
+		{
+			field.Distances = previousField->Distances;
+			FMazePathfinding::UpdateDistances(mazeGrid, WallDiff, field.GoalCells, field.Distances);
+		}
+		else
+		{
+			FMazePathfinding::ComputeDistances(mazeGrid, field.GoalCells, field.Distances);
+		}
+	}
+
+	//Readers get the new snapshot from here on
+	PublishedSlotIdx.Store(slotIdx);
+}
+
+void FMazeSolver::OnUpdateFinished()
+{
+	IsUpdating = false;
+	if (IsUpdatePending)
+		StartUpdate();
+}
@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MazeGrid.h"
+#include "MazeWallDiff.h"
+#include "MazeSolver.generated.h"
+
+UENUM(BlueprintType)
+enum class EMazePathAlgorithm : uint8 {
+	BREADTHFIRSTSEARCH = 0 UMETA(DisplayName = "Breadth-First Search"),
+	ASTAR = 1 UMETA(DisplayName = "A*"),
+};
+
+/**
+ * Distance of every cell to the closest of a set of goals, shared by all agents that walk to the same goals.
+ * The flow field is the distance field itself, an agent steps to the open neighbor that is one closer.
+ */
+struct FMazeDistanceField
+{
+	int Id = INDEX_NONE;
+	TArray<FVector> GoalLocations;
+	TArray<int> GoalCells;
+	TArray<int32> Distances;
+};
+
+/**
+ * The walls and distance fields of one maze epoch, a published snapshot is never written to.
+ */
+struct MAZEGENERATION_API FMazeSolverSnapshot
+{
+	int Epoch = INDEX_NONE;
+	FMazeGrid MazeGrid;
+	TArray<FMazeDistanceField> DistanceFields;
+
+	const FMazeDistanceField* FindDistanceField(int fieldId) const;
+	bool FindPath(int startCellIdx, int goalCellIdx, EMazePathAlgorithm algorithm, TArray<int>& outCells) const;
+	/*The cell one step closer to the goals of a field, INDEX_NONE on a goal or if the goals can't be reached.*/
+	int GetNextCell(int fieldId, int cellIdx) const;
+};
+
+/**
+ * Keeps a snapshot from being reused while it is read, release it as soon as the queries are done.
+ */
+class MAZEGENERATION_API FMazeSolverSnapshotRef
+{
+public:
+	FMazeSolverSnapshotRef() = default;
+	FMazeSolverSnapshotRef(const FMazeSolverSnapshot* snapshot, TAtomic<int>* nrOfReaders);
+	FMazeSolverSnapshotRef(FMazeSolverSnapshotRef&& other);
+	FMazeSolverSnapshotRef& operator=(FMazeSolverSnapshotRef&& other);
+	FMazeSolverSnapshotRef(const FMazeSolverSnapshotRef&) = delete;
+	FMazeSolverSnapshotRef& operator=(const FMazeSolverSnapshotRef&) = delete;
+	~FMazeSolverSnapshotRef();
+
+	void Release();
+
+	FORCEINLINE bool IsValid() const { return Snapshot != nullptr; }
+	FORCEINLINE const FMazeSolverSnapshot* operator->() const { return Snapshot; }
+	FORCEINLINE const FMazeSolverSnapshot& operator*() const { return *Snapshot; }
+
+private:
+	const FMazeSolverSnapshot* Snapshot = nullptr;
+	TAtomic<int>* NrOfReaders = nullptr;
+};
+
+/**
+ * Paths and distance fields of one maze.
+ * The game thread hands every new maze to the solver, a worker repairs the distance fields and publishes them as a new snapshot.
+ * Any thread can acquire the latest snapshot without locking, snapshots live in a few fixed slots that are reused once nobody reads them.
+ */
+class MAZEGENERATION_API FMazeSolver : public TSharedFromThis<FMazeSolver, ESPMode::ThreadSafe>
+{
+public:
+	/*Game thread. The walls are copied, so the grid can change right after.*/
+	void SetMaze(const FMazeGrid& mazeGrid, int epoch);
+	/*Game thread. Returns the id of the new field, it is in the snapshots from the next update on.*/
+	int AddDistanceField(const TArray<FVector>& goalLocations);
+	void RemoveDistanceField(int fieldId);
+
+	/*Any thread, lock-free. The reference is empty until the first snapshot is published.*/
+	FMazeSolverSnapshotRef AcquireSnapshot() const;
+
+private:
+	static const int NrOfSnapshotSlots = 4;
+
+	struct FSnapshotSlot
+	{
+		FMazeSolverSnapshot Snapshot;
+		mutable TAtomic<int> NrOfReaders{ 0 };
+	};
+
+	void RequestUpdate();
+	void StartUpdate();
+	void UpdateSnapshot(int slotIdx, int previousSlotIdx);
+	void OnUpdateFinished();
+
+	FSnapshotSlot Slots[NrOfSnapshotSlots];
+	TAtomic<int> PublishedSlotIdx{ INDEX_NONE };
+
+	//Game thread, the maze and goals of the next update
+	FMazeGrid LatestMaze;
+	int LatestEpoch = INDEX_NONE;
+	TArray<FMazeDistanceField> DistanceFieldGoals;
+	int NextDistanceFieldId = 0;
+	bool IsUpdating = false;
+	bool IsUpdatePending = false;
+
+	//Only used by the worker, one update runs at a time
+	FMazeWallDiff WallDiff;
+};
@@ -0,0 +1,132 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MazeSolverSubsystem.h"
+#include "MazeGenerator.h"
+#include "AIController.h"
+#include "NavigationData.h"
+
+void UMazeSolverSubsystem::Deinitialize()
+{
+	//Readers that still hold a solver keep it alive
+	Solvers.Empty();
+
+	Super::Deinitialize();
+}
+
+void UMazeSolverSubsystem::SetMaze(const AMazeGenerator* mazeGenerator, const FMazeGrid& mazeGrid, int epoch)
+{
+	FindOrAddSolver(mazeGenerator)->SetMaze(mazeGrid, epoch);
+}
+
+void UMazeSolverSubsystem::RemoveMaze(const AMazeGenerator* mazeGenerator)
+{
+	Solvers.Remove(mazeGenerator);
+}
+
+TSharedPtr<FMazeSolver, ESPMode::ThreadSafe> UMazeSolverSubsystem::GetSolver(const AMazeGenerator* mazeGenerator) const
+{
+	const TSharedPtr<FMazeSolver, ESPMode::ThreadSafe>* mazeSolver = Solvers.Find(mazeGenerator);
+	return mazeSolver ? *mazeSolver : nullptr;
+}
+
+int32 UMazeSolverSubsystem::AddDistanceField(AMazeGenerator* mazeGenerator, const TArray<FVector>& goalLocations)
+{
+	if (!mazeGenerator)
+		return INDEX_NONE;
+
+	return FindOrAddSolver(mazeGenerator)->AddDistanceField(goalLocations);
+}
+
+void UMazeSolverSubsystem::RemoveDistanceField(AMazeGenerator* mazeGenerator, int32 fieldId)
+{
+	if (TSharedPtr<FMazeSolver, ESPMode::ThreadSafe> mazeSolver = GetSolver(mazeGenerator))
+		mazeSolver->RemoveDistanceField(fieldId);
+}
+
+bool UMazeSolverSubsystem::FindPath(AMazeGenerator* mazeGenerator, FVector startLocation, FVector goalLocation, EMazePathAlgorithm algorithm, TArray<FVector>& outPath) const
+{
+	outPath.Reset();
+	TSharedPtr<FMazeSolver, ESPMode::ThreadSafe> mazeSolver = GetSolver(mazeGenerator);
+	if (!mazeSolver)
+		return false;
+
+	FMazeSolverSnapshotRef snapshot = mazeSolver->AcquireSnapshot();
+	if (!snapshot.IsValid())
+		return false;
+
+	const FMazeGrid& mazeGrid = snapshot->MazeGrid;
+	int startRow{}, startCol{}, goalRow{}, goalCol{};
+	if (!mazeGrid.GetCellCoordinates(startLocation, startRow, startCol) || !mazeGrid.GetCellCoordinates(goalLocation, goalRow, goalCol))
+		return false;
+
+	TArray<int> pathCells{};
+	if (!snapshot->FindPath(mazeGrid.GetCellIndex(startRow, startCol), mazeGrid.GetCellIndex(goalRow, goalCol), algorithm, pathCells))
+		return false;
+
+	outPath.Reserve(pathCells.Num());
+	for (int cellIdx : pathCells)
+	{
+		outPath.Add(mazeGrid.GetCellPosition(cellIdx));
+	}
+	return true;
+}
+
+bool UMazeSolverSubsystem::GetFlowDirection(AMazeGenerator* mazeGenerator, int32 fieldId, FVector location, FVector& outDirection) const
+{
+	outDirection = FVector::ZeroVector;
+	TSharedPtr<FMazeSolver, ESPMode::ThreadSafe> mazeSolver = GetSolver(mazeGenerator);
+	if (!mazeSolver)
+		return false;
+
+	FMazeSolverSnapshotRef snapshot = mazeSolver->AcquireSnapshot();
+	if (!snapshot.IsValid())
+		return false;
+
+	const FMazeGrid& mazeGrid = snapshot->MazeGrid;
+	int row{}, col{};
+	if (!mazeGrid.GetCellCoordinates(location, row, col))
+		return false;
+
+	const int cellIdx = mazeGrid.GetCellIndex(row, col);
+	const int nextCellIdx = snapshot->GetNextCell(fieldId, cellIdx);
+	if (nextCellIdx == INDEX_NONE)
+		return false;
+
+	outDirection = (mazeGrid.GetCellPosition(nextCellIdx) - mazeGrid.GetCellPosition(cellIdx)).GetSafeNormal();
+	return true;
+}
+
+bool UMazeSolverSubsystem::MoveToLocation(AAIController* controller, AMazeGenerator* mazeGenerator, FVector goalLocation, EMazePathAlgorithm algorithm, float acceptanceRadius) const
+{
+	APawn* pawn = controller ? controller->GetPawn() : nullptr;
+	if (!pawn)
+		return false;
+
+	const FVector pawnLocation = pawn->GetActorLocation();
+	TArray<FVector> pathPoints{};
+	if (!FindPath(mazeGenerator, pawnLocation, goalLocation, algorithm, pathPoints))
+		return false;
+
+	//The cell centers are on the floor, the pawn walks through them at its own height
+	pathPoints.Insert(pawnLocation, 0);
+	pathPoints.Add(goalLocation);
+	for (FVector& pathPoint : pathPoints)
+	{
+		pathPoint.Z = pawnLocation.Z;
+	}
+
+	FAIMoveRequest moveRequest(goalLocation);
+	moveRequest.SetUsePathfinding(false);
+	moveRequest.SetAcceptanceRadius(acceptanceRadius);
+	FNavPathSharedPtr path = MakeShared<FNavigationPath, ESPMode::ThreadSafe>(pathPoints, pawn);
+	return controller->RequestMove(moveRequest, path).IsValid();
+}
+
+TSharedPtr<FMazeSolver, ESPMode::ThreadSafe> UMazeSolverSubsystem::FindOrAddSolver(const AMazeGenerator* mazeGenerator)
+{
+	TSharedPtr<FMazeSolver, ESPMode::ThreadSafe>& mazeSolver = Solvers.FindOrAdd(mazeGenerator);
+	if (!mazeSolver)
+		mazeSolver = MakeShared<FMazeSolver, ESPMode::ThreadSafe>();
+	return mazeSolver;
+}
@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MazeSolver.h"
+#include "MazeSolverSubsystem.generated.h"
+
+class AMazeGenerator;
+class AAIController;
+
+/**
+ * Keeps a solver for every maze generator in the world, the generators hand it every maze they show.
+ * AI on other threads gets the solver of a maze once and acquires snapshots from it, the functions here are for the game thread.
+ */
+UCLASS()
+class MAZEGENERATION_API UMazeSolverSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	void SetMaze(const AMazeGenerator* mazeGenerator, const FMazeGrid& mazeGrid, int epoch);
+	void RemoveMaze(const AMazeGenerator* mazeGenerator);
+
+	/*The solver of a maze, keep the pointer to query it from any thread.*/
+	TSharedPtr<FMazeSolver, ESPMode::ThreadSafe> GetSolver(const AMazeGenerator* mazeGenerator) const;
+
+	/*Starts keeping the distance to the closest goal for every cell, agents walking to these goals share it. Returns the id of the field.*/
+	UFUNCTION(BlueprintCallable, Category = "Maze solver")
+		int32 AddDistanceField(AMazeGenerator* mazeGenerator, const TArray<FVector>& goalLocations);
+
+	UFUNCTION(BlueprintCallable, Category = "Maze solver")
+		void RemoveDistanceField(AMazeGenerator* mazeGenerator, int32 fieldId);
+
+	/*Path through the cell centers of the latest published maze, false if there is no path.*/
+	UFUNCTION(BlueprintCallable, Category = "Maze solver")
+		bool FindPath(AMazeGenerator* mazeGenerator, FVector startLocation, FVector goalLocation, EMazePathAlgorithm algorithm, TArray<FVector>& outPath) const;
+
+	/*Direction to the next cell on the way to the goals of a distance field, false on a goal or if the goals can't be reached.*/
+	UFUNCTION(BlueprintCallable, Category = "Maze solver")
+		bool GetFlowDirection(AMazeGenerator* mazeGenerator, int32 fieldId, FVector location, FVector& outDirection) const;
+
+	/*Moves an AI along a path of the maze graph without the nav mesh, false if there is no path. The path is of the maze at the time of the call, move again when the maze changes.*/
+	UFUNCTION(BlueprintCallable, Category = "Maze solver")
+		bool MoveToLocation(AAIController* controller, AMazeGenerator* mazeGenerator, FVector goalLocation, EMazePathAlgorithm algorithm, float acceptanceRadius = 50.f) const;
+
+private:
+	TSharedPtr<FMazeSolver, ESPMode::ThreadSafe> FindOrAddSolver(const AMazeGenerator* mazeGenerator);
+
+	TMap<TWeakObjectPtr<const AMazeGenerator>, TSharedPtr<FMazeSolver, ESPMode::ThreadSafe>> Solvers;
+};
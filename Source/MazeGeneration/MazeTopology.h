@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+enum class EMazeTopology : uint8
+{
+	Square = 0,
+	Hex = 1,
+	Layered = 2,
+};
+
+/**
+ * A step from a cell to one of its neighbors.
+ * Every wall is a single bit owned by one of the two cells, the cell the forward step starts from.
+ */
+struct FMazeTopologyEdge
+{
+	int8 LayerOffset;
+	int8 RowOffset;
+	int8 ColOffset;
+	/*The wall plane of the cell that owns the wall.*/
+	uint8 Plane;
+	/*A step back crosses the wall of the neighbor it goes to.*/
+	bool IsOwnedByNeighbor;
+};
+
+/**
+ * The neighbors of a cell, as tables that are known at compile time so loops over them unroll.
+ * The first NrOfWallPlanes edges are the forward steps, in the order of their wall planes.
+ */
+struct FMazeSquareTopology
+{
+	static constexpr EMazeTopology Topology = EMazeTopology::Square;
+	static constexpr int NrOfNeighbors = 4;
+	static constexpr int NrOfWallPlanes = 2;
+	static constexpr bool IsLayered = false;
+
+	//East, south, west, north
+	static FORCEINLINE const FMazeTopologyEdge* GetEdges(int row)
+	{
+		static constexpr FMazeTopologyEdge Edges[NrOfNeighbors] = {
+			{ 0, 0, 1, 0, false }, { 0, 1, 0, 1, false }, { 0, 0, -1, 0, true }, { 0, -1, 0, 1, true } };
+		return Edges;
+	}
+};
+
+/**
+ * Hexagons in rows, every odd row is shifted half a cell to the east.
+ * Which cells are diagonal neighbors depends on whether the row is even or odd.
+ */
+struct FMazeHexTopology
+{
+	static constexpr EMazeTopology Topology = EMazeTopology::Hex;
+	static constexpr int NrOfNeighbors = 6;
+	static constexpr int NrOfWallPlanes = 3;
+	static constexpr bool IsLayered = false;
+
+	//East, south-east, south-west, west, north-east, north-west
+	static FORCEINLINE const FMazeTopologyEdge* GetEdges(int row)
+	{
+		static constexpr FMazeTopologyEdge Edges[2][NrOfNeighbors] = {
+			{ { 0, 0, 1, 0, false }, { 0, 1, 0, 1, false }, { 0, 1, -1, 2, false }, { 0, 0, -1, 0, true }, { 0, -1, 0, 2, true }, { 0, -1, -1, 1, true } },
+			{ { 0, 0, 1, 0, false }, { 0, 1, 1, 1, false }, { 0, 1, 0, 2, false }, { 0, 0, -1, 0, true }, { 0, -1, 1, 2, true }, { 0, -1, 0, 1, true } } };
+		return Edges[row & 1];
+	}
+};
+
+/**
+ * Square floors stacked on top of each other, every cell can also go a floor down or up.
+ */
+struct FMazeLayeredTopology
+{
+	static constexpr EMazeTopology Topology = EMazeTopology::Layered;
+	static constexpr int NrOfNeighbors = 6;
+	static constexpr int NrOfWallPlanes = 3;
+	static constexpr bool IsLayered = true;
+
+	//East, south, down, west, north, up
+	static FORCEINLINE const FMazeTopologyEdge* GetEdges(int row)
+	{
+		static constexpr FMazeTopologyEdge Edges[NrOfNeighbors] = {
+			{ 0, 0, 1, 0, false }, { 0, 1, 0, 1, false }, { 1, 0, 0, 2, false }, { 0, 0, -1, 0, true }, { 0, -1, 0, 1, true }, { -1, 0, 0, 2, true } };
+		return Edges;
+	}
+};
@@ -0,0 +1,153 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MazeTopology.h"
+
+/**
+ * A maze grid of any topology, laid out like FMazeGrid.
+ * Every wall plane is a block of rows padded to whole 64 bit words, for every layer. Walls on the border are never set.
+ * The amount of neighbors and their offsets come from the topology, so the generators compile a kernel per topology.
+ */
+template<typename TTopology>
+struct TMazeTopologyGrid
+{
+	static constexpr int NrOfNeighbors = TTopology::NrOfNeighbors;
+	static constexpr int NrOfWallPlanes = TTopology::NrOfWallPlanes;
+
+	/*Sizes the grid, all inner walls are closed and no cell is visited. Only a layered topology has more than one layer.*/
+	void Init(int nrOfColumns, int nrOfRows, int nrOfLayers = 1)
+	{
+		NrOfColumns = FMath::Max(nrOfColumns, 0);
+		NrOfRows = FMath::Max(nrOfRows, 0);
+		NrOfLayers = TTopology::IsLayered ? FMath::Max(nrOfLayers, 0) : FMath::Clamp(nrOfLayers, 0, 1);
+		NrOfWordsPerRow = (NrOfColumns + 63) / 64;
+		ResetWalls();
+		ResetVisited();
+	}
+
+	void ResetWalls()
+	{
+		Walls.SetNumUninitialized(NrOfWallPlanes * NrOfLayers * NrOfRows * NrOfWordsPerRow);
+
+		//A wall exists where the forward step of its plane stays in the grid
+		for (int plane = 0; plane < NrOfWallPlanes; plane++)
+		{
+			for (int layer = 0; layer < NrOfLayers; layer++)
+			{
+				for (int row = 0; row < NrOfRows; row++)
+				{
+					const FMazeTopologyEdge& edge = TTopology::GetEdges(row)[plane];
+					const bool isInGrid = IsInRange(layer + edge.LayerOffset, NrOfLayers) && IsInRange(row + edge.RowOffset, NrOfRows);
+					for (int word = 0; word < NrOfWordsPerRow; word++)
+					{
+						const int firstCol = word * 64;
+						const int nrOfCols = FMath::Min(64, NrOfColumns - firstCol);
+						uint64 wallMask = nrOfCols == 64 ? ~0ull : (1ull << nrOfCols) - 1;
+						if (edge.ColOffset > 0 && firstCol + nrOfCols == NrOfColumns)
+							wallMask &= ~(1ull << (nrOfCols - 1));
+						if (edge.ColOffset < 0 && word == 0)
+							wallMask &= ~1ull;
+
+						Walls[GetWallIndex(layer, row, firstCol, plane) >> 6] = isInGrid ? wallMask : 0;
+					}
+				}
+			}
+		}
+	}
+
+	void ResetVisited() { Visited.Init(false, GetNrOfCells()); }
+
+	FORCEINLINE int GetNrOfCells() const { return NrOfLayers * NrOfRows * NrOfColumns; }
+	FORCEINLINE SIZE_T GetAllocatedSize() const { return Walls.GetAllocatedSize() + Visited.GetAllocatedSize(); }
+	FORCEINLINE int GetCellIndex(int layer, int row, int col) const { return (layer * NrOfRows + row) * NrOfColumns + col; }
+	FORCEINLINE int GetWallIndex(int layer, int row, int col, int plane) const
+	{
+		return ((plane * NrOfLayers + layer) * NrOfRows + row) * NrOfWordsPerRow * 64 + col;
+	}
+
+	FORCEINLINE bool IsWall(int wallIdx) const { return (Walls[wallIdx >> 6] >> (wallIdx & 63)) & 1; }
+	FORCEINLINE void SetWall(int wallIdx) { Walls[wallIdx >> 6] |= 1ull << (wallIdx & 63); }
+	FORCEINLINE void RemoveWall(int wallIdx) { Walls[wallIdx >> 6] &= ~(1ull << (wallIdx & 63)); }
+
+	FORCEINLINE bool IsVisited(int cellIdx) const { return Visited[cellIdx]; }
+	FORCEINLINE void SetVisited(int cellIdx) { Visited[cellIdx] = true; }
+
+	/*Fills the adjacent cells and the walls in between, returns the amount of neighbors.*/
+	FORCEINLINE int GetNeighbors(int cellIdx, int(&outCells)[NrOfNeighbors], int(&outWalls)[NrOfNeighbors]) const
+	{
+		const int col = cellIdx % NrOfColumns;
+		const int row = (cellIdx / NrOfColumns) % NrOfRows;
+		const int layer = cellIdx / (NrOfColumns * NrOfRows);
+		const FMazeTopologyEdge* edges = TTopology::GetEdges(row);
+
+		int nrOfNeighbors = 0;
+		for (int i = 0; i < NrOfNeighbors; i++)
+		{
+			const FMazeTopologyEdge& edge = edges[i];
+			const int neighborLayer = layer + edge.LayerOffset;
+			const int neighborRow = row + edge.RowOffset;
+			const int neighborCol = col + edge.ColOffset;
+			if (!IsInRange(neighborLayer, NrOfLayers) || !IsInRange(neighborRow, NrOfRows) || !IsInRange(neighborCol, NrOfColumns))
+				continue;
+
+			outCells[nrOfNeighbors] = GetCellIndex(neighborLayer, neighborRow, neighborCol);
+			outWalls[nrOfNeighbors++] = edge.IsOwnedByNeighbor
+				? GetWallIndex(neighborLayer, neighborRow, neighborCol, edge.Plane)
+				: GetWallIndex(layer, row, col, edge.Plane);
+		}
+		return nrOfNeighbors;
+	}
+
+	/*Gets the two cells a wall separates, returns false if the index is not an inner wall of the grid.*/
+	bool GetWallCells(int wallIdx, int& outFromCellIdx, int& outToCellIdx) const
+	{
+		const int nrOfBitsPerRow = NrOfWordsPerRow * 64;
+		const int nrOfBitsPerPlane = NrOfLayers * NrOfRows * nrOfBitsPerRow;
+		if (wallIdx < 0 || nrOfBitsPerPlane == 0 || wallIdx >= NrOfWallPlanes * nrOfBitsPerPlane)
+			return false;
+
+		const int plane = wallIdx / nrOfBitsPerPlane;
+		const int col = wallIdx % nrOfBitsPerRow;
+		const int row = (wallIdx / nrOfBitsPerRow) % NrOfRows;
+		const int layer = (wallIdx % nrOfBitsPerPlane) / (NrOfRows * nrOfBitsPerRow);
+		const FMazeTopologyEdge& edge = TTopology::GetEdges(row)[plane];
+		if (!IsInRange(col, NrOfColumns) || !IsInRange(layer + edge.LayerOffset, NrOfLayers)
+			|| !IsInRange(row + edge.RowOffset, NrOfRows) || !IsInRange(col + edge.ColOffset, NrOfColumns))
+			return false;
+
+		outFromCellIdx = GetCellIndex(layer, row, col);
+		outToCellIdx = GetCellIndex(layer + edge.LayerOffset, row + edge.RowOffset, col + edge.ColOffset);
+		return true;
+	}
+
+	/*Calls func(wallIdx) for every wall that is set, in increasing wall index order.*/
+	template<typename FunctionType>
+	void ForEachWall(FunctionType&& func) const
+	{
+		for (int wordIdx = 0; wordIdx < Walls.Num(); wordIdx++)
+		{
+			uint64 word = Walls[wordIdx];
+			while (word)
+			{
+				func(wordIdx * 64 + (int)FMath::CountTrailingZeros64(word));
+				word &= word - 1;
+			}
+		}
+	}
+
+	int NrOfColumns = 0;
+	int NrOfRows = 0;
+	int NrOfLayers = 0;
+	int NrOfWordsPerRow = 0;
+
+	TArray<uint64> Walls;
+	TBitArray<> Visited;
+
+private:
+	static FORCEINLINE bool IsInRange(int idx, int num) { return (uint32)idx < (uint32)num; }
+};
+
+using FMazeHexGrid = TMazeTopologyGrid<FMazeHexTopology>;
+using FMazeLayeredGrid = TMazeTopologyGrid<FMazeLayeredTopology>;
@@ -0,0 +1,120 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MazeTransformTable.h"
+#include "MazeGeneration.h"
+#include "Async/ParallelFor.h"
+#include "Kismet/KismetMathLibrary.h"
+
+namespace
+{
+	const float HiddenWallScale = 0.001f;
+}
+
+FMazeTransformTable::FMazeTransformTable()
+	:MazeStartPosition()
+	, NrOfMazeColumns(-1)
+	, NrOfMazeRows(-1)
+	, MazeTileSize(0)
+	, Cells()
+{
+}
+
+bool FMazeTransformTable::Matches(const FMazeGrid& mazeGrid, const FIntRect& cells) const
+{
+	return NrOfMazeColumns == mazeGrid.NrOfMazeColumns
+		&& NrOfMazeRows == mazeGrid.NrOfMazeRows
+		&& MazeTileSize == mazeGrid.MazeTileSize
+		&& MazeStartPosition == mazeGrid.MazeStartPosition
+		&& Cells == cells;
+}
+
+void FMazeTransformTable::Build(const FMazeGrid& mazeGrid, const FIntRect& cells)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MazeBuildTransforms);
+	TRACE_CPUPROFILER_EVENT_SCOPE(FMazeTransformTable::Build);
+
+	MazeStartPosition = mazeGrid.MazeStartPosition;
+	NrOfMazeColumns = mazeGrid.NrOfMazeColumns;
+	NrOfMazeRows = mazeGrid.NrOfMazeRows;
+	MazeTileSize = mazeGrid.MazeTileSize;
+	Cells = cells;
+
+	//Only four rotations exist in the maze
+	const FQuat eastWallRotation = UKismetMathLibrary::FindLookAtRotation({ 1,0,0 }, { 0,0,0 }).Quaternion();
+	const FQuat southWallRotation = UKismetMathLibrary::FindLookAtRotation({ 0,-1,0 }, { 0,0,0 }).Quaternion();
+	const FQuat outerWallRotationX = UKismetMathLibrary::FindLookAtRotation({ 0,1,0 }, { 0,0,0 }).Quaternion();
+	const FQuat outerWallRotationY = eastWallRotation;
+
+	const int nrOfCols = Cells.Width();
+	const int nrOfCells = nrOfCols * Cells.Height();
+
+	//Floors
+	FloorTransforms.SetNumUninitialized(nrOfCells);
+	ParallelFor(nrOfCells, [&](int localCellIdx)
+	{
+		const int cellIdx = mazeGrid.GetCellIndex(Cells.Min.Y + localCellIdx / nrOfCols, Cells.Min.X + localCellIdx % nrOfCols);
+		FloorTransforms[localCellIdx] = FTransform(mazeGrid.GetCellPosition(cellIdx));
+	});
+
+	//Outer walls on the border of the maze, the bottom and top walls of every column followed by the left and right walls of every row
+	OuterWallTransforms.Reset();
+	for (int col = Cells.Min.X; col < Cells.Max.X; col++)
+	{
+		const float wallX = MazeStartPosition.X + col * MazeTileSize - MazeTileSize / 2;
+		if (Cells.Min.Y == 0)
+			OuterWallTransforms.Add(FTransform(outerWallRotationX, { wallX, MazeStartPosition.Y, 0 }));
+		if (Cells.Max.Y == NrOfMazeRows)
+			OuterWallTransforms.Add(FTransform(outerWallRotationX, { wallX, MazeStartPosition.Y - NrOfMazeRows * MazeTileSize, 0 }));
+	}
+	for (int row = Cells.Min.Y; row < Cells.Max.Y; row++)
+	{
+		const float wallY = MazeStartPosition.Y - row * MazeTileSize - MazeTileSize / 2;
+		if (Cells.Min.X == 0)
+			OuterWallTransforms.Add(FTransform(outerWallRotationY, { MazeStartPosition.X - MazeTileSize, wallY, 0 }));
+		if (Cells.Max.X == NrOfMazeColumns)
+			OuterWallTransforms.Add(FTransform(outerWallRotationY, { MazeStartPosition.X + MazeTileSize * NrOfMazeColumns - MazeTileSize, wallY, 0 }));
+	}
+
+	//Inner walls, the slots past the last column and row never hold a wall but keep the layout regular
+	InnerWallIndices.SetNumUninitialized(nrOfCells * FMazeGrid::NrOfWallPlanes);
+	InnerWallTransforms.SetNumUninitialized(nrOfCells * FMazeGrid::NrOfWallPlanes);
+	ParallelFor(nrOfCells, [&](int localCellIdx)
+	{
+		const int row = Cells.Min.Y + localCellIdx / nrOfCols;
+		const int col = Cells.Min.X + localCellIdx % nrOfCols;
+		const FVector cellPosition = mazeGrid.GetCellPosition(mazeGrid.GetCellIndex(row, col));
+		const int eastSlot = localCellIdx * FMazeGrid::NrOfWallPlanes + FMazeGrid::East;
+		const int southSlot = localCellIdx * FMazeGrid::NrOfWallPlanes + FMazeGrid::South;
+
+		InnerWallIndices[eastSlot] = col + 1 < NrOfMazeColumns ? mazeGrid.GetWallIndex(row, col, FMazeGrid::East) : INDEX_NONE;
+		InnerWallIndices[southSlot] = row + 1 < NrOfMazeRows ? mazeGrid.GetWallIndex(row, col, FMazeGrid::South) : INDEX_NONE;
+		InnerWallTransforms[eastSlot] = FTransform(eastWallRotation, cellPosition + FVector(MazeTileSize / 2, 0, 0));
+		InnerWallTransforms[southSlot] = FTransform(southWallRotation, cellPosition - FVector(0, MazeTileSize / 2, 0));
+	});
+}
+
+void FMazeTransformTable::Empty()
+{
+	FloorTransforms.Empty();
+	OuterWallTransforms.Empty();
+	InnerWallTransforms.Empty();
+	InnerWallIndices.Empty();
+	NrOfMazeColumns = -1;
+	NrOfMazeRows = -1;
+}
+
+FTransform FMazeTransformTable::GetInnerWallTransform(int slot, bool isVisible) const
+{
+	FTransform wallTransform = InnerWallTransforms[slot];
+	if (!isVisible)
+		HideWall(wallTransform, MazeTileSize);
+	return wallTransform;
+}
+
+void FMazeTransformTable::HideWall(FTransform& wallTransform, float mazeTileSize)
+{
+	//A zero scale would break the physics body of the instance
+	wallTransform.AddToTranslation(FVector(0, 0, -mazeTileSize));
+	wallTransform.SetScale3D(FVector(HiddenWallScale));
+}
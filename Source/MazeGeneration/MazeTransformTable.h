@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MazeGrid.h"
+
+/**
+ * World transforms of the floors and walls of a rectangle of cells of a maze.
+ * The geometry only depends on the rows, columns, tile size and start position, so the table is
+ * only rebuilt when one of those changes.
+ */
+struct MAZEGENERATION_API FMazeTransformTable
+{
+	FMazeTransformTable();
+
+	/*Cells is the rectangle of columns (X) and rows (Y) the table covers, the max is exclusive.*/
+	bool Matches(const FMazeGrid& mazeGrid, const FIntRect& cells) const;
+	void Build(const FMazeGrid& mazeGrid, const FIntRect& cells);
+	void Empty();
+
+	FORCEINLINE int GetNrOfInnerWalls() const { return InnerWallTransforms.Num(); }
+	FORCEINLINE SIZE_T GetAllocatedSize() const
+	{
+		return FloorTransforms.GetAllocatedSize() + OuterWallTransforms.GetAllocatedSize()
+			+ InnerWallTransforms.GetAllocatedSize() + InnerWallIndices.GetAllocatedSize();
+	}
+
+	/*Every cell of the table owns a slot for its east and its south wall.*/
+	FORCEINLINE int GetInnerWallSlot(int row, int col, FMazeGrid::EWallPlane plane) const
+	{
+		return ((row - Cells.Min.Y) * Cells.Width() + col - Cells.Min.X) * FMazeGrid::NrOfWallPlanes + plane;
+	}
+
+	/*Transform of an inner wall slot, openings are shrunk below the floor instead of removed.*/
+	FTransform GetInnerWallTransform(int slot, bool isVisible) const;
+	static void HideWall(FTransform& wallTransform, float mazeTileSize);
+
+	TArray<FTransform> FloorTransforms;
+	TArray<FTransform> OuterWallTransforms;
+	TArray<FTransform> InnerWallTransforms;
+
+	//Wall index of every inner wall slot, INDEX_NONE for the slots past the last column and row
+	TArray<int> InnerWallIndices;
+
+private:
+	FVector MazeStartPosition;
+	int NrOfMazeColumns;
+	int NrOfMazeRows;
+	float MazeTileSize;
+	FIntRect Cells;
+};
@@ -0,0 +1,117 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MazeWallCollision.h"
+#include "MazeGrid.h"
+#include "MazeGeneration.h"
+
+void FMazeWallCollision::BuildBoxes(const FMazeGrid& mazeGrid, const FIntRect& cells, const FBox& eastWallBox, const FBox& southWallBox, TArray<FBox>& outBoxes)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MazeBuildWallCollision);
+	TRACE_CPUPROFILER_EVENT_SCOPE(FMazeWallCollision::BuildBoxes);
+
+	outBoxes.Reset();
+	const float tileSize = mazeGrid.MazeTileSize;
+	auto getWallBox = [&](const FBox& wallBox, int row, int col)
+	{
+		//Rows go down along the Y-axis
+		return wallBox.ShiftBy(FVector((col - cells.Min.X) * tileSize, -(row - cells.Min.Y) * tileSize, 0));
+	};
+
+	//East walls are merged down a column, the row past the block ends the last run
+	for (int col = cells.Min.X; col < cells.Max.X; col++)
+	{
+		int firstRow = INDEX_NONE;
+		for (int row = cells.Min.Y; row <= cells.Max.Y; row++)
+		{
+			const bool isWall = row < cells.Max.Y && mazeGrid.IsWall(mazeGrid.GetWallIndex(row, col, FMazeGrid::East));
+			if (isWall && firstRow == INDEX_NONE)
+			{
+				firstRow = row;
+			}
+			else if (!isWall && firstRow != INDEX_NONE)
+			{
+				outBoxes.Add(getWallBox(eastWallBox, firstRow, col) + getWallBox(eastWallBox, row - 1, col));
+				firstRow = INDEX_NONE;
+			}
+		}
+	}
+
+	//South walls are merged along a row
+	for (int row = cells.Min.Y; row < cells.Max.Y; row++)
+	{
+		int firstCol = INDEX_NONE;
+		for (int col = cells.Min.X; col <= cells.Max.X; col++)
+		{
+			const bool isWall = col < cells.Max.X && mazeGrid.IsWall(mazeGrid.GetWallIndex(row, col, FMazeGrid::South));
+			if (isWall && firstCol == INDEX_NONE)
+			{
+				firstCol = col;
+			}
+			else if (!isWall && firstCol != INDEX_NONE)
+			{
+				outBoxes.Add(getWallBox(southWallBox, row, firstCol) + getWallBox(southWallBox, row, col - 1));
+				firstCol = INDEX_NONE;
+			}
+		}
+	}
+}
+
+bool FMazeWallCollision::LineTrace(const FMazeGrid& mazeGrid, const FVector& start, const FVector& end, FVector& outHitLocation, FVector& outHitNormal)
+{
+	const float tileSize = mazeGrid.MazeTileSize;
+	if (tileSize <= 0)
+		return false;
+
+	//In cell space a cell spans [col, col + 1) and [row, row + 1), cell centers are half a tile before the column and after the row
+	const FVector2D from{ (start.X - mazeGrid.MazeStartPosition.X) / tileSize + 1, (mazeGrid.MazeStartPosition.Y - start.Y) / tileSize };
+	const FVector2D to{ (end.X - mazeGrid.MazeStartPosition.X) / tileSize + 1, (mazeGrid.MazeStartPosition.Y - end.Y) / tileSize };
+	const FVector2D delta = to - from;
+
+	int col = FMath::FloorToInt(from.X);
+	int row = FMath::FloorToInt(from.Y);
+	if (col < 0 || col >= mazeGrid.NrOfMazeColumns || row < 0 || row >= mazeGrid.NrOfMazeRows)
+		return false;
+
+	//Walk the cells along the line, the time is where on the line the next column and row border is crossed
+	const int colStep = delta.X > 0 ? 1 : -1;
+	const int rowStep = delta.Y > 0 ? 1 : -1;
+	const float colTimeStep = delta.X != 0 ? FMath::Abs(1 / delta.X) : MAX_flt;
+	const float rowTimeStep = delta.Y != 0 ? FMath::Abs(1 / delta.Y) : MAX_flt;
+	float nextColTime = delta.X != 0 ? ((colStep > 0 ? col + 1 : col) - from.X) / delta.X : MAX_flt;
+	float nextRowTime = delta.Y != 0 ? ((rowStep > 0 ? row + 1 : row) - from.Y) / delta.Y : MAX_flt;
+
+	while (true)
+	{
+		const bool isColBorder = nextColTime < nextRowTime;
+		const float time = isColBorder ? nextColTime : nextRowTime;
+		if (time > 1)
+			return false;
+
+		bool isBlocked{};
+		if (isColBorder)
+		{
+			const int nextCol = col + colStep;
+			isBlocked = nextCol < 0 || nextCol >= mazeGrid.NrOfMazeColumns
+				|| mazeGrid.IsWall(mazeGrid.GetWallIndex(row, FMath::Min(col, nextCol), FMazeGrid::East));
+			outHitNormal = FVector(-colStep, 0, 0);
+			col = nextCol;
+			nextColTime += colTimeStep;
+		}
+		else
+		{
+			const int nextRow = row + rowStep;
+			isBlocked = nextRow < 0 || nextRow >= mazeGrid.NrOfMazeRows
+				|| mazeGrid.IsWall(mazeGrid.GetWallIndex(FMath::Min(row, nextRow), col, FMazeGrid::South));
+			outHitNormal = FVector(0, rowStep, 0);
+			row = nextRow;
+			nextRowTime += rowTimeStep;
+		}
+
+		if (isBlocked)
+		{
+			outHitLocation = start + (end - start) * time;
+			return true;
+		}
+	}
+}
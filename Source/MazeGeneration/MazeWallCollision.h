@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FMazeGrid;
+
+/**
+ * The boxes of one chunk, built on a worker and handed to the chunk on the game thread.
+ */
+struct FMazeChunkCollisionBuild
+{
+	int ChunkIdx = INDEX_NONE;
+	int BuildId = INDEX_NONE;
+	FIntRect Cells;
+	FBox EastWallBox;
+	FBox SouthWallBox;
+	TArray<FBox> Boxes;
+};
+
+/**
+ * Collision of the inner walls without a physics body per wall.
+ * Every function only reads the grid, so it can run on any thread on a grid nobody writes to.
+ */
+struct MAZEGENERATION_API FMazeWallCollision
+{
+	/**
+	 * Merges the inner walls of a block of cells into boxes, walls in one line become one box.
+	 * The wall boxes are the bounds of the east and south wall of the first cell of the block, the others are shifted from those.
+	 */
+	static void BuildBoxes(const FMazeGrid& mazeGrid, const FIntRect& cells, const FBox& eastWallBox, const FBox& southWallBox, TArray<FBox>& outBoxes);
+
+	/**
+	 * Traces a line in the XY-plane through the cells, walls are planes on the cell borders and the border of the maze is closed.
+	 * Returns false if nothing is hit or the line starts outside the maze.
+	 */
+	static bool LineTrace(const FMazeGrid& mazeGrid, const FVector& start, const FVector& end, FVector& outHitLocation, FVector& outHitNormal);
+};
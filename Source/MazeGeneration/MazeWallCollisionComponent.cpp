@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MazeWallCollisionComponent.h"
+#include "PhysicsEngine/BodySetup.h"
+
+UMazeWallCollisionComponent::UMazeWallCollisionComponent()
+	:WallBodySetup(nullptr)
+	, LocalBounds(ForceInit)
+{
+	PrimaryComponentTick.bCanEverTick = false;
+	SetCanEverAffectNavigation(false);
+	SetGenerateOverlapEvents(false);
+}
+
+void UMazeWallCollisionComponent::SetBoxes(const TArray<FBox>& worldBoxes)
+{
+	if (!WallBodySetup)
+	{
+		WallBodySetup = NewObject<UBodySetup>(this, NAME_None, RF_Transient);
+		WallBodySetup->CollisionTraceFlag = CTF_UseSimpleAsComplex;
+		WallBodySetup->bGenerateMirroredCollision = false;
+	}
+
+	const FTransform& componentTransform = GetComponentTransform();
+	WallBodySetup->AggGeom.BoxElems.Reset(worldBoxes.Num());
+	LocalBounds.Init();
+	for (const FBox& worldBox : worldBoxes)
+	{
+		const FBox localBox = worldBox.InverseTransformBy(componentTransform);
+		const FVector boxSize = localBox.GetSize();
+		FKBoxElem& boxElem = WallBodySetup->AggGeom.BoxElems.Emplace_GetRef(boxSize.X, boxSize.Y, boxSize.Z);
+		boxElem.Center = localBox.GetCenter();
+		LocalBounds += localBox;
+	}
+
+	//Boxes don't need cooking, only the body is created again
+	WallBodySetup->InvalidatePhysicsData();
+	WallBodySetup->CreatePhysicsMeshes();
+	RecreatePhysicsState();
+	UpdateBounds();
+}
+
+UBodySetup* UMazeWallCollisionComponent::GetBodySetup()
+{
+	return WallBodySetup;
+}
+
+bool UMazeWallCollisionComponent::ShouldCreatePhysicsState() const
+{
+	//A body without shapes isn't created
+	return WallBodySetup && WallBodySetup->AggGeom.GetElementCount() > 0 && Super::ShouldCreatePhysicsState();
+}
+
+FBoxSphereBounds UMazeWallCollisionComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+	if (!LocalBounds.IsValid)
+		return FBoxSphereBounds(LocalToWorld.GetLocation(), FVector::ZeroVector, 0.f);
+
+	return FBoxSphereBounds(LocalBounds.TransformBy(LocalToWorld));
+}
@@ -0,0 +1,35 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/PrimitiveComponent.h"
+#include "MazeWallCollisionComponent.generated.h"
+
+class UBodySetup;
+
+/**
+ * The walls of a chunk as one physics body made of boxes, so a maze change rebuilds one body instead of a body per wall.
+ * It only blocks, the walls are drawn and in the nav mesh through their instanced meshes.
+ */
+UCLASS(ClassGroup = Collision)
+class MAZEGENERATION_API UMazeWallCollisionComponent : public UPrimitiveComponent
+{
+	GENERATED_BODY()
+
+public:
+	UMazeWallCollisionComponent();
+
+	/*Replaces all boxes of the body, the boxes are in world space.*/
+	void SetBoxes(const TArray<FBox>& worldBoxes);
+
+	virtual UBodySetup* GetBodySetup() override;
+	virtual bool ShouldCreatePhysicsState() const override;
+	virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
+
+private:
+	UPROPERTY(Transient)
+		UBodySetup* WallBodySetup;
+
+	FBox LocalBounds;
+};
@@ -0,0 +1,18 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MazeWallComponent.h"
+
+UMazeWallComponent::UMazeWallComponent(const FObjectInitializer& ObjectInitializer)
+	:Super(ObjectInitializer)
+{
+	//Walls without collision still export their mesh to the nav mesh, the collision can come from merged boxes instead
+	bHasCustomNavigableGeometry = EHasCustomNavigableGeometry::EvenIfNotCollision;
+}
+
+void UMazeWallComponent::PartialNavigationUpdate(int32 InstanceIdx)
+{
+	//Only the new bounds of an instance would be dirtied, a wall that sinks into the floor would stay in the nav mesh. Updates of the whole component still go through
+	if (InstanceIdx == INDEX_NONE)
+		Super::PartialNavigationUpdate(InstanceIdx);
+}
@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "MazeWallComponent.generated.h"
+
+/**
+ * Instanced inner walls of a maze.
+ * A moved instance doesn't dirty the navigation around it, the maze generator dirties the area of the walls that changed itself.
+ */
+UCLASS(ClassGroup = Rendering, meta = (BlueprintSpawnableComponent))
+class MAZEGENERATION_API UMazeWallComponent : public UHierarchicalInstancedStaticMeshComponent
+{
+	GENERATED_BODY()
+
+public:
+	UMazeWallComponent(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	virtual void PartialNavigationUpdate(int32 InstanceIdx) override;
+};
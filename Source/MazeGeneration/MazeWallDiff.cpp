@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MazeWallDiff.h"
+#include "MazeGeneration.h"
+
+void FMazeWallDiff::Reset()
+{
+	RemovedWalls.Reset();
+	AddedWalls.Reset();
+}
+
+void FMazeWallDiff::Compute(const TArray<uint64>& oldWalls, const TArray<uint64>& newWalls)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MazeWallDiff);
+	TRACE_CPUPROFILER_EVENT_SCOPE(FMazeWallDiff::Compute);
+
+	Reset();
+
+	const int nrOfWords = FMath::Min(oldWalls.Num(), newWalls.Num());
+	const uint64* oldWords = oldWalls.GetData();
+	const uint64* newWords = newWalls.GetData();
+	int wordIdx = 0;
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS
+	//Four words at a time, blocks without any change are skipped after a single OR of the XOR results
+	alignas(16) uint64 removedWords[4];
+	alignas(16) uint64 addedWords[4];
+	for (; wordIdx + 4 <= nrOfWords; wordIdx += 4)
+	{
+		const VectorRegisterInt oldA = VectorIntLoad(oldWords + wordIdx);
+		const VectorRegisterInt oldB = VectorIntLoad(oldWords + wordIdx + 2);
+		const VectorRegisterInt newA = VectorIntLoad(newWords + wordIdx);
+		const VectorRegisterInt newB = VectorIntLoad(newWords + wordIdx + 2);
+
+		VectorIntStore(VectorIntOr(VectorIntXor(oldA, newA), VectorIntXor(oldB, newB)), removedWords);
+		if ((removedWords[0] | removedWords[1]) == 0)
+			continue;
+
+		//AndNot(A, B) is ~A & B
+		VectorIntStore(VectorIntAndNot(newA, oldA), removedWords);
+		VectorIntStore(VectorIntAndNot(newB, oldB), removedWords + 2);
+		VectorIntStore(VectorIntAndNot(oldA, newA), addedWords);
+		VectorIntStore(VectorIntAndNot(oldB, newB), addedWords + 2);
+
+		for (int lane = 0; lane < 4; lane++)
+		{
+			AppendWallIndices(RemovedWalls, wordIdx + lane, removedWords[lane]);
+			AppendWallIndices(AddedWalls, wordIdx + lane, addedWords[lane]);
+		}
+	}
+#endif
+
+	for (; wordIdx < nrOfWords; wordIdx++)
+	{
+		if (oldWords[wordIdx] == newWords[wordIdx])
+			continue;
+
+		AppendWallIndices(RemovedWalls, wordIdx, oldWords[wordIdx] & ~newWords[wordIdx]);
+		AppendWallIndices(AddedWalls, wordIdx, newWords[wordIdx] & ~oldWords[wordIdx]);
+	}
+
+	//Words only one of the sets has
+	for (; wordIdx < oldWalls.Num(); wordIdx++)
+		AppendWallIndices(RemovedWalls, wordIdx, oldWords[wordIdx]);
+	for (; wordIdx < newWalls.Num(); wordIdx++)
+		AppendWallIndices(AddedWalls, wordIdx, newWords[wordIdx]);
+}
+
+void FMazeWallDiff::AppendWallIndices(TArray<int>& wallIndices, int wordIdx, uint64 word)
+{
+	if (word == 0)
+		return;
+
+	//The popcount sizes the list once per word instead of growing it per wall
+	const int firstIdx = wallIndices.AddUninitialized(FMath::CountBits(word));
+	int* wallIdx = wallIndices.GetData() + firstIdx;
+	while (word)
+	{
+		*wallIdx++ = wordIdx * 64 + (int)FMath::CountTrailingZeros64(word);
+		word &= word - 1;
+	}
+}
@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Difference between two bit-packed wall sets (see FMazeGrid::Walls), as lists of wall indices.
+ * Used by the erosion fx, the inner wall instances and the on screen telemetry.
+ */
+struct MAZEGENERATION_API FMazeWallDiff
+{
+	/*Computes both lists in a single pass over the words, the lists keep their memory between calls.*/
+	void Compute(const TArray<uint64>& oldWalls, const TArray<uint64>& newWalls);
+	void Reset();
+
+	FORCEINLINE int GetNrOfChangedWalls() const { return RemovedWalls.Num() + AddedWalls.Num(); }
+	FORCEINLINE SIZE_T GetAllocatedSize() const { return RemovedWalls.GetAllocatedSize() + AddedWalls.GetAllocatedSize(); }
+
+	/*Walls of the old maze that are openings in the new maze.*/
+	TArray<int> RemovedWalls;
+	/*Openings of the old maze that are walls in the new maze.*/
+	TArray<int> AddedWalls;
+
+private:
+	static void AppendWallIndices(TArray<int>& wallIndices, int wordIdx, uint64 word);
+};
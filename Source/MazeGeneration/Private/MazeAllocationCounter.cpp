@@ -0,0 +1,206 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MazeAllocationCounter.h"
+
+FMazeAllocationCounter::~FMazeAllocationCounter()
+{
+	if (Blocks)
+		InnerMalloc->Free(Blocks);
+}
+
+void FMazeAllocationCounter::Install()
+{
+	//Installing twice would forward to itself
+	check(InnerMalloc == nullptr);
+	InnerMalloc = GMalloc;
+	GMalloc = this;
+}
+
+void FMazeAllocationCounter::Uninstall()
+{
+	//The counter keeps forwarding, allocations that were made while it was installed can still be freed through it
+	check(GMalloc == this);
+	GMalloc = InnerMalloc;
+}
+
+void FMazeAllocationCounter::Reset()
+{
+	{
+		FScopeLock scopeLock(&BlocksLock);
+		if (Blocks)
+			FMemory::Memzero(Blocks, BlockCapacity * sizeof(FCountedBlock));
+		NrOfBlocks = 0;
+	}
+	NrOfAllocations = 0;
+	LiveBytes = 0;
+	PeakBytes = 0;
+}
+
+void* FMazeAllocationCounter::Malloc(SIZE_T count, uint32 alignment)
+{
+	void* allocation = InnerMalloc->Malloc(count, alignment);
+	if (IsCounting)
+	{
+		++NrOfAllocations;
+		AddBytes(allocation);
+	}
+	return allocation;
+}
+
+void* FMazeAllocationCounter::Realloc(void* original, SIZE_T count, uint32 alignment)
+{
+	if (!IsCounting)
+		return InnerMalloc->Realloc(original, count, alignment);
+
+	//A realloc without an original block is a new allocation
+	if (original == nullptr)
+		++NrOfAllocations;
+
+	RemoveBytes(original);
+	void* allocation = InnerMalloc->Realloc(original, count, alignment);
+	AddBytes(allocation);
+	return allocation;
+}
+
+void FMazeAllocationCounter::Free(void* original)
+{
+	if (IsCounting)
+		RemoveBytes(original);
+	InnerMalloc->Free(original);
+}
+
+bool FMazeAllocationCounter::GetAllocationSize(void* original, SIZE_T& outSize)
+{
+	return InnerMalloc->GetAllocationSize(original, outSize);
+}
+
+SIZE_T FMazeAllocationCounter::QuantizeSize(SIZE_T count, uint32 alignment)
+{
+	return InnerMalloc->QuantizeSize(count, alignment);
+}
+
+void FMazeAllocationCounter::Trim(bool bTrimThreadCaches)
+{
+	InnerMalloc->Trim(bTrimThreadCaches);
+}
+
+void FMazeAllocationCounter::SetupTLSCachesOnCurrentThread()
+{
+	InnerMalloc->SetupTLSCachesOnCurrentThread();
+}
+
+void FMazeAllocationCounter::ClearAndDisableTLSCachesOnCurrentThread()
+{
+	InnerMalloc->ClearAndDisableTLSCachesOnCurrentThread();
+}
+
+bool FMazeAllocationCounter::IsInternallyThreadSafe() const
+{
+	return InnerMalloc->IsInternallyThreadSafe();
+}
+
+bool FMazeAllocationCounter::ValidateHeap()
+{
+	return InnerMalloc->ValidateHeap();
+}
+
+const TCHAR* FMazeAllocationCounter::GetDescriptiveName()
+{
+	return TEXT("MazeAllocationCounter");
+}
+
+void FMazeAllocationCounter::AddBytes(void* allocation)
+{
+	//Only allocators that know the size of a block are measured, so every block is added and removed with the same size
+	SIZE_T size{};
+	if (allocation == nullptr || !InnerMalloc->GetAllocationSize(allocation, size))
+		return;
+
+	AddBlock(allocation, (int64)size);
+	const int64 liveBytes = LiveBytes += (int64)size;
+	int64 peakBytes = PeakBytes.Load();
+	while (liveBytes > peakBytes && !PeakBytes.CompareExchange(peakBytes, liveBytes))
+	{
+	}
+}
+
+void FMazeAllocationCounter::RemoveBytes(void* allocation)
+{
+	//Blocks from before Reset weren't added, removing them would push the memory in use below zero and the peak too low
+	int64 size{};
+	if (allocation != nullptr && RemoveBlock(allocation, size))
+		LiveBytes -= size;
+}
+
+void FMazeAllocationCounter::AddBlock(void* allocation, int64 size)
+{
+	FScopeLock scopeLock(&BlocksLock);
+	if ((NrOfBlocks + 1) * 2 > BlockCapacity)
+		GrowBlocks();
+
+	int64 slot = GetBlockSlot(allocation);
+	while (Blocks[slot].Allocation != nullptr && Blocks[slot].Allocation != allocation)
+	{
+		slot = (slot + 1) & (BlockCapacity - 1);
+	}
+	NrOfBlocks += Blocks[slot].Allocation == nullptr;
+	Blocks[slot] = { allocation, size };
+}
+
+bool FMazeAllocationCounter::RemoveBlock(void* allocation, int64& outSize)
+{
+	FScopeLock scopeLock(&BlocksLock);
+	if (NrOfBlocks == 0)
+		return false;
+
+	int64 slot = GetBlockSlot(allocation);
+	while (Blocks[slot].Allocation != allocation)
+	{
+		if (Blocks[slot].Allocation == nullptr)
+			return false;
+		slot = (slot + 1) & (BlockCapacity - 1);
+	}
+	outSize = Blocks[slot].Size;
+	NrOfBlocks--;
+
+	//Blocks after the hole that can't be found from their own slot anymore are shifted back, so no tombstones are needed
+	int64 holeSlot = slot;
+	for (int64 nextSlot = (slot + 1) & (BlockCapacity - 1); Blocks[nextSlot].Allocation != nullptr; nextSlot = (nextSlot + 1) & (BlockCapacity - 1))
+	{
+		const int64 homeSlot = GetBlockSlot(Blocks[nextSlot].Allocation);
+		const bool isReachable = holeSlot <= nextSlot ? (holeSlot < homeSlot && homeSlot <= nextSlot) : (holeSlot < homeSlot || homeSlot <= nextSlot);
+		if (isReachable)
+			continue;
+
+		Blocks[holeSlot] = Blocks[nextSlot];
+		holeSlot = nextSlot;
+	}
+	Blocks[holeSlot] = { nullptr, 0 };
+	return true;
+}
+
+void FMazeAllocationCounter::GrowBlocks()
+{
+	FCountedBlock* oldBlocks = Blocks;
+	const int64 oldCapacity = BlockCapacity;
+	BlockCapacity = FMath::Max<int64>(oldCapacity * 2, 4096);
+	Blocks = (FCountedBlock*)InnerMalloc->Malloc(BlockCapacity * sizeof(FCountedBlock), alignof(FCountedBlock));
+	FMemory::Memzero(Blocks, BlockCapacity * sizeof(FCountedBlock));
+
+	for (int64 oldSlot = 0; oldSlot < oldCapacity; oldSlot++)
+	{
+		if (oldBlocks[oldSlot].Allocation == nullptr)
+			continue;
+
+		int64 slot = GetBlockSlot(oldBlocks[oldSlot].Allocation);
+		while (Blocks[slot].Allocation != nullptr)
+		{
+			slot = (slot + 1) & (BlockCapacity - 1);
+		}
+		Blocks[slot] = oldBlocks[oldSlot];
+	}
+
+	if (oldBlocks)
+		InnerMalloc->Free(oldBlocks);
+}
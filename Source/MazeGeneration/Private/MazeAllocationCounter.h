@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/CriticalSection.h"
+
+/**
+ * Counts the allocations and the memory in use while it is counting, installed in front of GMalloc.
+ * Every call is forwarded to the allocator it replaced. It is installed once, blocks allocated through it can still be freed through it after it is removed.
+ */
+class FMazeAllocationCounter : public FMalloc
+{
+public:
+	~FMazeAllocationCounter();
+
+	void Install();
+	void Uninstall();
+
+	/*Only allocations between these calls are counted, the counter stays installed.*/
+	FORCEINLINE void StartCounting() { IsCounting = true; }
+	FORCEINLINE void StopCounting() { IsCounting = false; }
+
+	/*Starts counting from zero, the peak is measured from the memory in use at this point. Only blocks allocated from here on are removed again.*/
+	void Reset();
+
+	FORCEINLINE int64 GetNrOfAllocations() const { return NrOfAllocations.Load(); }
+	FORCEINLINE int64 GetPeakBytes() const { return PeakBytes.Load(); }
+
+	virtual void* Malloc(SIZE_T count, uint32 alignment) override;
+	virtual void* Realloc(void* original, SIZE_T count, uint32 alignment) override;
+	virtual void Free(void* original) override;
+	virtual bool GetAllocationSize(void* original, SIZE_T& outSize) override;
+	virtual SIZE_T QuantizeSize(SIZE_T count, uint32 alignment) override;
+	virtual void Trim(bool bTrimThreadCaches) override;
+	virtual void SetupTLSCachesOnCurrentThread() override;
+	virtual void ClearAndDisableTLSCachesOnCurrentThread() override;
+	virtual bool IsInternallyThreadSafe() const override;
+	virtual bool ValidateHeap() override;
+	virtual const TCHAR* GetDescriptiveName() override;
+
+private:
+	struct FCountedBlock
+	{
+		void* Allocation;
+		int64 Size;
+	};
+
+	void AddBytes(void* allocation);
+	void RemoveBytes(void* allocation);
+
+	//An open addressing table of the blocks allocated while counting, it lives in the inner allocator so tracking a block never comes back through the counter
+	void AddBlock(void* allocation, int64 size);
+	bool RemoveBlock(void* allocation, int64& outSize);
+	void GrowBlocks();
+	FORCEINLINE int64 GetBlockSlot(void* allocation) const { return (int64)((UPTRINT)allocation >> 4) & (BlockCapacity - 1); }
+
+	FMalloc* InnerMalloc = nullptr;
+	FCriticalSection BlocksLock;
+	FCountedBlock* Blocks = nullptr;
+	int64 BlockCapacity = 0;
+	int64 NrOfBlocks = 0;
+	TAtomic<bool> IsCounting{ false };
+	TAtomic<int64> NrOfAllocations{ 0 };
+	TAtomic<int64> LiveBytes{ 0 };
+	TAtomic<int64> PeakBytes{ 0 };
+};
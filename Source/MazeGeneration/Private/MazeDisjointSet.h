@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Disjoint-set forest over cell indices, with path compression and union by rank.
+ */
+struct FMazeDisjointSet
+{
+	/*Puts every element in a set of its own, the memory is kept when the amount of elements doesn't grow and the arrays never shrink.*/
+	void Init(int nrOfElements)
+	{
+		Parents.SetNumUninitialized(nrOfElements, false);
+		Ranks.SetNumUninitialized(nrOfElements, false);
+		FMemory::Memzero(Ranks.GetData(), nrOfElements * sizeof(uint8));
+		for (int idx = 0; idx < nrOfElements; idx++)
+			Parents[idx] = idx;
+	}
+
+	int Find(int idx)
+	{
+		//Find the root, then point every element on the way directly to it
+		int root = idx;
+		while (Parents[root] != root)
+			root = Parents[root];
+
+		while (Parents[idx] != root)
+		{
+			const int next = Parents[idx];
+			Parents[idx] = root;
+			idx = next;
+		}
+		return root;
+	}
+
+	/*Merges the sets of both elements, returns false if they already were in the same set.*/
+	bool Union(int idxA, int idxB)
+	{
+		int rootA = Find(idxA);
+		int rootB = Find(idxB);
+		if (rootA == rootB)
+			return false;
+
+		if (Ranks[rootA] < Ranks[rootB])
+			Swap(rootA, rootB);
+
+		Parents[rootB] = rootA;
+		if (Ranks[rootA] == Ranks[rootB])
+			Ranks[rootA]++;
+		return true;
+	}
+
+	FORCEINLINE SIZE_T GetAllocatedSize() const { return Parents.GetAllocatedSize() + Ranks.GetAllocatedSize(); }
+
+	TArray<int> Parents;
+	TArray<uint8> Ranks;
+};
@@ -0,0 +1,140 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MazeGenerationRing.h"
+#include "MazeGenerationScratch.h"
+
+FMazeGenerationRing::FSlot::FSlot()
+	:Maze(MakeShared<FMazeGrid, ESPMode::ThreadSafe>())
+	, Scratch(MakeShared<FMazeGenerationScratch, ESPMode::ThreadSafe>())
+{
+}
+
+void FMazeGenerationRing::FSlot::MarkReady(int nrOfMutationMoves)
+{
+	ReadyTime = FPlatformTime::Seconds();
+	NrOfMutationMoves = nrOfMutationMoves;
+
+	//Read before the ready flag, from then on the game thread can hand the slot out again
+	TSharedPtr<TAtomic<int>, ESPMode::ThreadSafe> nrOfRunningWorkers = NrOfRunningWorkers;
+	IsReady.Store(true);
+	--(*nrOfRunningWorkers);
+}
+
+void FMazeGenerationRing::Reset(int capacity, int firstEpoch)
+{
+	//A slot that is still generated into is replaced, its worker keeps the old slot alive until it is done
+	for (TSharedRef<FSlot, ESPMode::ThreadSafe>& slot : Slots)
+	{
+		if (slot->IsRequested && !slot->IsReady.Load())
+			slot = MakeShared<FSlot, ESPMode::ThreadSafe>();
+
+		slot->Epoch = INDEX_NONE;
+		slot->IsRequested = false;
+		slot->IsReady.Store(false);
+	}
+
+	//The other slots keep their buffers for the next mazes
+	capacity = FMath::Max(capacity, 1);
+	if (Slots.Num() > capacity)
+		Slots.RemoveAt(capacity, Slots.Num() - capacity);
+	while (Slots.Num() < capacity)
+	{
+		Slots.Add(MakeShared<FSlot, ESPMode::ThreadSafe>());
+	}
+
+	FirstEpoch = firstEpoch;
+	NextEpoch = firstEpoch;
+}
+
+void FMazeGenerationRing::Empty()
+{
+	Slots.Empty();
+	FirstEpoch = 0;
+	NextEpoch = 0;
+}
+
+TSharedPtr<FMazeGenerationRing::FSlot, ESPMode::ThreadSafe> FMazeGenerationRing::RequestNext(int maxWorkers)
+{
+	//Backpressure, the workers never get more than a ring ahead of the maze on screen
+	if (Slots.Num() == 0 || NextEpoch - FirstEpoch >= Slots.Num() || NrOfRunningWorkers->Load() >= maxWorkers)
+		return nullptr;
+
+	const TSharedRef<FSlot, ESPMode::ThreadSafe>& slot = GetSlot(NextEpoch);
+	slot->Epoch = NextEpoch++;
+	slot->IsRequested = true;
+	slot->IsReady.Store(false);
+	slot->RequestTime = FPlatformTime::Seconds();
+	slot->NrOfRunningWorkers = NrOfRunningWorkers;
+	++(*NrOfRunningWorkers);
+	return slot;
+}
+
+const FMazeGenerationRing::FSlot* FMazeGenerationRing::FindSlot(int epoch) const
+{
+	if (epoch < FirstEpoch || epoch >= NextEpoch)
+		return nullptr;
+
+	return &GetSlot(epoch).Get();
+}
+
+bool FMazeGenerationRing::IsFirstRequested(int epoch, int32 seed) const
+{
+	if (FirstEpoch != epoch || NextEpoch == FirstEpoch)
+		return false;
+
+	const FSlot& slot = *GetSlot(FirstEpoch);
+	return slot.IsRequested && slot.Seed == seed;
+}
+
+bool FMazeGenerationRing::IsFirstReady() const
+{
+	return NextEpoch > FirstEpoch && GetSlot(FirstEpoch)->IsReady.Load();
+}
+
+void FMazeGenerationRing::PopFirst(TSharedPtr<FMazeGrid, ESPMode::ThreadSafe>& inOutMaze, int& outEpoch, int32& outSeed, double& outLatencySeconds, int& outNrOfMutationMoves)
+{
+	check(IsFirstReady());
+
+	FSlot& slot = *GetSlot(FirstEpoch++);
+	Swap(inOutMaze, slot.Maze);
+	outEpoch = slot.Epoch;
+	outSeed = slot.Seed;
+	outLatencySeconds = slot.ReadyTime - slot.RequestTime;
+	outNrOfMutationMoves = slot.NrOfMutationMoves;
+
+	slot.Epoch = INDEX_NONE;
+	slot.IsRequested = false;
+	slot.IsReady.Store(false);
+}
+
+int FMazeGenerationRing::GetNrOfReady() const
+{
+	int nrOfReady = 0;
+	for (const TSharedRef<FSlot, ESPMode::ThreadSafe>& slot : Slots)
+	{
+		nrOfReady += slot->IsRequested && slot->IsReady.Load();
+	}
+	return nrOfReady;
+}
+
+int FMazeGenerationRing::GetNrOfGenerating() const
+{
+	int nrOfGenerating = 0;
+	for (const TSharedRef<FSlot, ESPMode::ThreadSafe>& slot : Slots)
+	{
+		nrOfGenerating += slot->IsRequested && !slot->IsReady.Load();
+	}
+	return nrOfGenerating;
+}
+
+SIZE_T FMazeGenerationRing::GetAllocatedSize() const
+{
+	SIZE_T allocatedSize = Slots.GetAllocatedSize();
+	for (const TSharedRef<FSlot, ESPMode::ThreadSafe>& slot : Slots)
+	{
+		if (!slot->IsRequested || slot->IsReady.Load())
+			allocatedSize += slot->Maze->GetAllocatedSize() + slot->Scratch->GetAllocatedSize();
+	}
+	return allocatedSize;
+}
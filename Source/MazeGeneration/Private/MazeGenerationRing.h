@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "../MazeGrid.h"
+
+struct FMazeGenerationScratch;
+
+/**
+ * The next mazes, generated ahead of time into a fixed ring of buffers by workers.
+ * The maze of an epoch always goes into the same slot. Only the game thread hands out slots and pops mazes, a worker only sets
+ * the ready flag of its own slot, so no locks are needed and popping a maze is a swap of two buffers.
+ */
+class FMazeGenerationRing
+{
+public:
+	struct FSlot
+	{
+		FSlot();
+
+		/*Worker. Hands the buffers back to the game thread, the worker must not touch the slot after this.*/
+		void MarkReady(int nrOfMutationMoves);
+
+		TSharedPtr<FMazeGrid, ESPMode::ThreadSafe> Maze;
+		TSharedPtr<FMazeGenerationScratch, ESPMode::ThreadSafe> Scratch;
+		int Epoch = INDEX_NONE;
+		int32 Seed = 0;
+		bool IsRequested = false;
+		double RequestTime = 0;
+
+		//Set by the worker once the maze is done, the buffers belong to the game thread again from then on
+		double ReadyTime = 0;
+		int NrOfMutationMoves = 0;
+		TAtomic<bool> IsReady{ false };
+
+		//Shared by all slots of the ring, a slot that a reset dropped still counts its worker until it is done
+		TSharedPtr<TAtomic<int>, ESPMode::ThreadSafe> NrOfRunningWorkers;
+	};
+
+	/*Drops all mazes and starts again at an epoch, workers that are still busy finish into slots of their own.*/
+	void Reset(int capacity, int firstEpoch);
+	void Empty();
+
+	/*Hands out the slot of the next epoch, nullptr when the ring is full or the maximum amount of workers are busy. Workers of dropped slots count as busy.*/
+	TSharedPtr<FSlot, ESPMode::ThreadSafe> RequestNext(int maxWorkers);
+
+	FORCEINLINE int GetFirstEpoch() const { return FirstEpoch; }
+	FORCEINLINE int GetNextEpoch() const { return NextEpoch; }
+	/*The slot of an epoch that is still in the ring, nullptr if it isn't requested or already popped.*/
+	const FSlot* FindSlot(int epoch) const;
+	bool IsFirstRequested(int epoch, int32 seed) const;
+	bool IsFirstReady() const;
+	/*Swaps the maze of the first epoch with a buffer that isn't shown anymore, its slot is free for the next epoch.*/
+	void PopFirst(TSharedPtr<FMazeGrid, ESPMode::ThreadSafe>& inOutMaze, int& outEpoch, int32& outSeed, double& outLatencySeconds, int& outNrOfMutationMoves);
+
+	int GetNrOfReady() const;
+	int GetNrOfGenerating() const;
+	/*The workers that are still generating, also the ones of slots a reset dropped.*/
+	FORCEINLINE int GetNrOfRunningWorkers() const { return NrOfRunningWorkers->Load(); }
+	/*Only the slots that aren't being generated into.*/
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	FORCEINLINE const TSharedRef<FSlot, ESPMode::ThreadSafe>& GetSlot(int epoch) const { return Slots[epoch % Slots.Num()]; }
+
+	TArray<TSharedRef<FSlot, ESPMode::ThreadSafe>> Slots;
+	int FirstEpoch = 0;
+	int NextEpoch = 0;
+	TSharedRef<TAtomic<int>, ESPMode::ThreadSafe> NrOfRunningWorkers = MakeShared<TAtomic<int>, ESPMode::ThreadSafe>(0);
+};
@@ -0,0 +1,23 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MazeGenerationScratch.h"
+
+SIZE_T FMazeGenerationScratch::GetAllocatedSize() const
+{
+	SIZE_T allocatedSize = CellStack.GetAllocatedSize() + Walls.GetAllocatedSize() + CellSets.GetAllocatedSize()
+		+ Frontier.GetAllocatedSize() + InFrontier.GetAllocatedSize()
+		+ EllersRow.GetAllocatedSize() + EastWalls.GetAllocatedSize() + SouthWalls.GetAllocatedSize()
+		+ VisitStamps.GetAllocatedSize() + Parents.GetAllocatedSize() + CellQueue.GetAllocatedSize() + Path.GetAllocatedSize()
+		+ TileGrids.GetAllocatedSize() + TileScratches.GetAllocatedSize() + TileBorders.GetAllocatedSize() + TileSets.GetAllocatedSize();
+
+	for (const FMazeGrid& tileGrid : TileGrids)
+	{
+		allocatedSize += tileGrid.GetAllocatedSize();
+	}
+	for (const TUniquePtr<FMazeGenerationScratch>& tileScratch : TileScratches)
+	{
+		allocatedSize += tileScratch->GetAllocatedSize();
+	}
+	return allocatedSize;
+}
@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MazeDisjointSet.h"
+#include "../MazeGrid.h"
+#include "../MazeEllersRow.h"
+
+/**
+ * Memory the generators keep between mazes.
+ * Everything is sized on first use, generating another maze of the same dimensions doesn't allocate.
+ * Only one generation at a time may use the same scratch.
+ */
+struct FMazeGenerationScratch
+{
+	//Random depth-first search
+	TArray<int> CellStack;
+
+	//Random Kruskal's
+	TArray<int> Walls;
+	FMazeDisjointSet CellSets;
+
+	//Random Prim's, cells next to the maze that are not part of it yet
+	TArray<int> Frontier;
+	TBitArray<> InFrontier;
+
+	//Eller's, the walls of the row that was carved last
+	FMazeEllersRow EllersRow;
+	TArray<uint64> EastWalls;
+	TArray<uint64> SouthWalls;
+
+	//Mutation, the search for the cycle a move makes
+	TArray<uint32> VisitStamps;
+	uint32 VisitStamp = 0;
+	TArray<int> Parents;
+	TArray<int> CellQueue;
+	TArray<int> Path;
+
+	//Tiled generation, every tile has a grid and scratch of its own so they can be generated at the same time
+	TArray<FMazeGrid> TileGrids;
+	TArray<TUniquePtr<FMazeGenerationScratch>> TileScratches;
+	TArray<int> TileBorders;
+	FMazeDisjointSet TileSets;
+
+	SIZE_T GetAllocatedSize() const;
+};
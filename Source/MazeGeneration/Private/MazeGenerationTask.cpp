@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MazeGenerationTask.h"
+#include "../MazeGenerator.h"
+#include "../RandomDepthFirstSearch.h"
+#include "RandomKruskals.h"
+#include "RandomPrims.h"
+#include "RandomEllers.h"
+#include "RandomBinaryTree.h"
+#include "RandomSidewinder.h"
+#include "RandomMutation.h"
+#include "TiledMazeGenerator.h"
+#include "MazeGenerationScratch.h"
+#include "Async/Async.h"
+#include "../MazeGeneration.h"
+
+FMazeGenerationTask::FMazeGenerationTask(const FMazeGenerationSettings& settings, TSharedRef<FMazeGrid, ESPMode::ThreadSafe> mazeGrid,
+	TSharedRef<FMazeGenerationScratch, ESPMode::ThreadSafe> scratch, TFunction<void(int)>&& onCompleted)
+	:Settings(settings)
+	, MazeGrid(mazeGrid)
+	, Scratch(scratch)
+	, OnCompleted(MoveTemp(onCompleted))
+{
+}
+
+void FMazeGenerationTask::DoWork()
+{
+	const int nrOfMutationMoves = Run(Settings, *MazeGrid, *Scratch);
+
+	//Hand the finished buffer back, the callback decides how the game thread hears about it
+	if (OnCompleted)
+		OnCompleted(nrOfMutationMoves);
+}
+
+int FMazeGenerationTask::Run(const FMazeGenerationSettings& settings, FMazeGrid& mazeGrid, FMazeGenerationScratch& scratch)
+{
+	if (!settings.IsMutatingBuffer)
+		Generate(settings, mazeGrid, scratch);
+	if (settings.MutationSeeds.Num() > 0)
+		return Mutate(settings, mazeGrid, scratch);
+	return 0;
+}
+
+void FMazeGenerationTask::Generate(const FMazeGenerationSettings& settings, FMazeGrid& mazeGrid, FMazeGenerationScratch& scratch)
+{
+	if (TiledMazeGenerator::IsTiled(settings, mazeGrid))
+	{
+		SCOPE_CYCLE_COUNTER(STAT_MazeCarveTiled);
+		TRACE_CPUPROFILER_EVENT_SCOPE(TiledMazeGenerator::DoWork);
+		TiledMazeGenerator tiledMazeGenerator(settings, mazeGrid, scratch);
+		tiledMazeGenerator.DoWork();
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_MazeCarve);
+	TRACE_CPUPROFILER_EVENT_SCOPE(FMazeGenerationTask::Generate);
+
+	const int32 seed = settings.Seed;
+	switch (settings.Algorithm)
+	{
+	case EMazeAlgorithm::RANDOMDEPTHFIRSTSEARCH:
+	{
+		RandomDepthFirstSearch randomDFS(mazeGrid, seed, scratch);
+		randomDFS.DoWork();
+		break;
+	}
+	case EMazeAlgorithm::RANDOMKRUSKALS:
+	{
+		RandomKruskals randomKruskals(mazeGrid, seed, scratch);
+		randomKruskals.DoWork();
+		break;
+	}
+	case EMazeAlgorithm::RANDOMPRISMS:
+	{
+		RandomPrims randomPrims(mazeGrid, seed, scratch);
+		randomPrims.DoWork();
+		break;
+	}
+	case EMazeAlgorithm::RANDOMELLERS:
+	{
+		RandomEllers randomEllers(mazeGrid, seed, scratch);
+		randomEllers.DoWork();
+		break;
+	}
+	case EMazeAlgorithm::RANDOMBINARYTREE:
+	{
+		RandomBinaryTree randomBinaryTree(mazeGrid, seed);
+		randomBinaryTree.DoWork();
+		break;
+	}
+	case EMazeAlgorithm::RANDOMSIDEWINDER:
+	{
+		RandomSidewinder randomSidewinder(mazeGrid, seed);
+		randomSidewinder.DoWork();
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+int FMazeGenerationTask::Mutate(const FMazeGenerationSettings& settings, FMazeGrid& mazeGrid, FMazeGenerationScratch& scratch)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MazeMutate);
+	TRACE_CPUPROFILER_EVENT_SCOPE(FMazeGenerationTask::Mutate);
+
+	//Every epoch mutates the maze of the epoch before it
+	RandomMutation randomMutation(mazeGrid, settings.MutationSeeds, settings.NrOfMutationMoves, scratch);
+	randomMutation.DoWork();
+	return randomMutation.GetNrOfMovesDone();
+}
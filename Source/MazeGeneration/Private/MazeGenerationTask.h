@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "../MazeGrid.h"
+
+enum class EMazeAlgorithm : uint8;
+struct FMazeGenerationScratch;
+
+/**
+ * How a maze is generated, the same settings generate the same maze on every machine.
+ */
+struct FMazeGenerationSettings
+{
+	EMazeAlgorithm Algorithm;
+	int32 Seed = 0;
+
+	/*Mazes bigger than one tile are generated tile by tile on all cores, 0 generates the whole maze at once.*/
+	int ParallelTileSize = 0;
+
+	/*Mutates the maze one epoch at a time with these seeds after it is generated, the moves of one epoch.*/
+	TArray<int32> MutationSeeds;
+	int NrOfMutationMoves = 0;
+	/*The buffer already holds the maze to mutate, so it isn't generated first.*/
+	bool IsMutatingBuffer = false;
+};
+
+/**
+ * Generates a maze into a back buffer on a worker thread.
+ * The worker is the only one touching the buffer until it is done, OnCompleted runs on the worker right after and hands the buffer back
+ * together with the moves the mutation made.
+ */
+class FMazeGenerationTask : public FNonAbandonableTask
+{
+public:
+	FMazeGenerationTask(const FMazeGenerationSettings& settings, TSharedRef<FMazeGrid, ESPMode::ThreadSafe> mazeGrid,
+		TSharedRef<FMazeGenerationScratch, ESPMode::ThreadSafe> scratch, TFunction<void(int)>&& onCompleted);
+
+	void DoWork();
+
+	/*Generates and mutates the maze the settings describe on the calling thread, returns the moves the last epoch of the mutation made.*/
+	static int Run(const FMazeGenerationSettings& settings, FMazeGrid& mazeGrid, FMazeGenerationScratch& scratch);
+
+	/*Runs the generator of the algorithm on the calling thread, the scratch keeps its memory for the next maze.*/
+	static void Generate(const FMazeGenerationSettings& settings, FMazeGrid& mazeGrid, FMazeGenerationScratch& scratch);
+	static int Mutate(const FMazeGenerationSettings& settings, FMazeGrid& mazeGrid, FMazeGenerationScratch& scratch);
+
+	FORCEINLINE TStatId GetStatId() const
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(FMazeGenerationTask, STATGROUP_ThreadPoolAsyncTasks)
+	}
+
+private:
+	FMazeGenerationSettings Settings;
+	TSharedRef<FMazeGrid, ESPMode::ThreadSafe> MazeGrid;
+	TSharedRef<FMazeGenerationScratch, ESPMode::ThreadSafe> Scratch;
+	TFunction<void(int)> OnCompleted;
+};
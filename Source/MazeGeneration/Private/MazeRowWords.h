@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "../MazeGrid.h"
+#include "Async/ParallelFor.h"
+
+/**
+ * Helpers for generators that carve a whole row of walls 64 cells at a time.
+ * The random words only depend on the seed, the row and the word, so rows can be carved in any order on any thread.
+ */
+struct FMazeRowWords
+{
+	//Rows are handed to the workers in batches, a single row is too little work for a task
+	static constexpr int NrOfRowsPerBatch = 64;
+
+	/*A random word of a row, every bit is a coin flip. Counter based (SplitMix64), so there is no stream to share between rows.*/
+	static FORCEINLINE uint64 GetRandomWord(int32 seed, int row, int idx)
+	{
+		uint64 word = ((uint64)(uint32)seed << 32 | (uint32)row) * 0x9E3779B97F4A7C15ull + (uint64)idx * 0xD1B54A32D192ED03ull;
+		word = (word ^ (word >> 30)) * 0xBF58476D1CE4E5B9ull;
+		word = (word ^ (word >> 27)) * 0x94D049BB133111EBull;
+		return word ^ (word >> 31);
+	}
+
+	/*The columns of a word that are in the maze, the padding of the last word isn't.*/
+	static FORCEINLINE uint64 GetColumnMask(const FMazeGrid& mazeGrid, int wordIdx)
+	{
+		const int nrOfCols = FMath::Min(64, mazeGrid.NrOfMazeColumns - wordIdx * 64);
+		return nrOfCols == 64 ? ~0ull : (1ull << nrOfCols) - 1;
+	}
+
+	/*The columns of a word that have an east wall, the last column of the maze doesn't.*/
+	static FORCEINLINE uint64 GetEastMask(const FMazeGrid& mazeGrid, int wordIdx)
+	{
+		const uint64 colMask = GetColumnMask(mazeGrid, wordIdx);
+		return wordIdx + 1 == mazeGrid.NrOfWordsPerRow ? colMask >> 1 : colMask;
+	}
+
+	/*Calls func(row, eastWalls, southWalls) for every row on all cores, the walls point at the words of the row in the grid.*/
+	template<typename FunctionType>
+	static void ForEachRowParallel(FMazeGrid& mazeGrid, FunctionType&& func)
+	{
+		const int nrOfRows = mazeGrid.NrOfMazeRows;
+		ParallelFor(FMath::DivideAndRoundUp(nrOfRows, NrOfRowsPerBatch), [&](int batchIdx)
+		{
+			const int lastRow = FMath::Min((batchIdx + 1) * NrOfRowsPerBatch, nrOfRows);
+			for (int row = batchIdx * NrOfRowsPerBatch; row < lastRow; row++)
+			{
+				uint64* eastWalls = &mazeGrid.Walls[mazeGrid.GetWallIndex(row, 0, FMazeGrid::East) >> 6];
+				uint64* southWalls = &mazeGrid.Walls[mazeGrid.GetWallIndex(row, 0, FMazeGrid::South) >> 6];
+				func(row, eastWalls, southWalls);
+			}
+		});
+	}
+};
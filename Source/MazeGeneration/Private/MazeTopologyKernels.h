@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MazeDisjointSet.h"
+
+/**
+ * The carve loops of the generators that only need the neighbors and walls of a cell, compiled once per grid type.
+ * The grid fixes the amount of neighbors and their offsets at compile time, so the neighbor loops unroll and nothing is dispatched per cell.
+ * Square mazes use FMazeGrid, hex and layered mazes TMazeTopologyGrid.
+ */
+template<typename GridType>
+struct TMazeTopologyKernels
+{
+	static constexpr int NrOfNeighbors = GridType::NrOfNeighbors;
+
+	/*Random depth-first search from the first cell, every cell is pushed at most once.*/
+	static void DepthFirst(GridType& mazeGrid, FRandomStream& randomStream, TArray<int>& cellStack)
+	{
+		if (mazeGrid.GetNrOfCells() == 0)
+			return;
+
+		//Every cell is pushed at most once, so the explicit stack never grows beyond the amount of cells
+		cellStack.Reset(mazeGrid.GetNrOfCells());
+		mazeGrid.SetVisited(0);
+		cellStack.Push(0);
+
+		int adjacentCells[NrOfNeighbors]{}, adjacentWalls[NrOfNeighbors]{};
+		int unvisitedCells[NrOfNeighbors]{}, unvisitedWalls[NrOfNeighbors]{};
+		while (cellStack.Num() > 0)
+		{
+			const int cellIdx = cellStack.Last();
+
+			//Gather the adjacent cells not visited yet
+			const int nrOfAdjacentCells = mazeGrid.GetNeighbors(cellIdx, adjacentCells, adjacentWalls);
+			int nrOfUnvisitedCells = 0;
+			for (int i = 0; i < nrOfAdjacentCells; i++)
+			{
+				if (!mazeGrid.IsVisited(adjacentCells[i]))
+				{
+					unvisitedCells[nrOfUnvisitedCells] = adjacentCells[i];
+					unvisitedWalls[nrOfUnvisitedCells++] = adjacentWalls[i];
+				}
+			}
+
+			//Backtrack to the previous cell when all adjacent cells are visited
+			if (nrOfUnvisitedCells == 0)
+			{
+				cellStack.Pop(false);
+				continue;
+			}
+
+			//Choose a random wall that goes to a cell not visited yet and remove it
+			const int randIdx = randomStream.RandRange(0, nrOfUnvisitedCells - 1);
+			mazeGrid.RemoveWall(unvisitedWalls[randIdx]);
+
+			//Go to unvisited cell
+			mazeGrid.SetVisited(unvisitedCells[randIdx]);
+			cellStack.Push(unvisitedCells[randIdx]);
+		}
+	}
+
+	/*Random Kruskal's, the walls are shuffled once and removed in order if they join two sets of cells.*/
+	static void Kruskals(GridType& mazeGrid, FRandomStream& randomStream, TArray<int>& walls, FMazeDisjointSet& cellSets)
+	{
+		//Every cell starts in its own set
+		cellSets.Init(mazeGrid.GetNrOfCells());
+
+		//Every wall in the grid is unique, the grid only stores the walls of the forward steps of a cell
+		walls.Reset(mazeGrid.GetNrOfCells() * GridType::NrOfWallPlanes);
+		mazeGrid.ForEachWall([&walls](int wallIdx)
+		{
+			walls.Add(wallIdx);
+		});
+
+		//Shuffle the walls once, so they can be consumed in order
+		for (int i = walls.Num() - 1; i > 0; i--)
+			walls.Swap(i, randomStream.RandRange(0, i));
+
+		//A spanning tree is done after joining every cell, that is one less than the amount of cells
+		int nrOfJoinsLeft = mazeGrid.GetNrOfCells() - 1;
+		int fromCellIdx{}, toCellIdx{};
+		for (int wallIdx : walls)
+		{
+			if (nrOfJoinsLeft <= 0)
+				break;
+
+			mazeGrid.GetWallCells(wallIdx, fromCellIdx, toCellIdx);
+
+			//Remove the wall if the cells don't belong to the same set
+			if (cellSets.Union(fromCellIdx, toCellIdx))
+			{
+				mazeGrid.RemoveWall(wallIdx);
+				nrOfJoinsLeft--;
+			}
+		}
+	}
+};
@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RandomBinaryTree.h"
+#include "../MazeGrid.h"
+#include "MazeRowWords.h"
+
+RandomBinaryTree::RandomBinaryTree(FMazeGrid& mazeGrid, int32 seed)
+	:MazeGrid(mazeGrid)
+	, Seed(seed)
+{
+
+}
+
+RandomBinaryTree::~RandomBinaryTree()
+{
+}
+
+void RandomBinaryTree::DoWork()
+{
+	//Every word of every row is written, so the walls aren't reset first and the visited cells aren't used
+	FMazeRowWords::ForEachRowParallel(MazeGrid, [this](int row, uint64* eastWalls, uint64* southWalls)
+	{
+		CarveRow(row, eastWalls, southWalls);
+	});
+}
+
+void RandomBinaryTree::CarveRow(int row, uint64* eastWalls, uint64* southWalls) const
+{
+	const int nrOfWordsPerRow = MazeGrid.NrOfWordsPerRow;
+
+	//The last row is one corridor to the east, every column ends up in it
+	if (row + 1 == MazeGrid.NrOfMazeRows)
+	{
+		FMemory::Memzero(eastWalls, nrOfWordsPerRow * sizeof(uint64));
+		FMemory::Memzero(southWalls, nrOfWordsPerRow * sizeof(uint64));
+		return;
+	}
+
+	for (int wordIdx = 0; wordIdx < nrOfWordsPerRow; wordIdx++)
+	{
+		//A cell that carves east keeps its south wall, the last column can only carve south
+		const uint64 isCarvedEast = FMazeRowWords::GetRandomWord(Seed, row, wordIdx) & FMazeRowWords::GetEastMask(MazeGrid, wordIdx);
+		eastWalls[wordIdx] = FMazeRowWords::GetEastMask(MazeGrid, wordIdx) & ~isCarvedEast;
+		southWalls[wordIdx] = isCarvedEast;
+	}
+}
@@ -0,0 +1,32 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FMazeGrid;
+
+/**
+ * Binary tree, every cell carves east or south at random.
+ * There is no state between cells, so a row is carved 64 cells at a time and the rows on all cores.
+ */
+class RandomBinaryTree : public FNonAbandonableTask
+{
+public:
+	RandomBinaryTree(FMazeGrid& mazeGrid, int32 seed);
+	~RandomBinaryTree();
+
+	void DoWork();
+
+	FORCEINLINE TStatId GetStatId() const
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(RandomBinaryTree, STATGROUP_ThreadPoolAsyncTasks)
+	}
+
+private:
+	void CarveRow(int row, uint64* eastWalls, uint64* southWalls) const;
+
+	FMazeGrid& MazeGrid;
+	int32 Seed;
+
+};
@@ -0,0 +1,48 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RandomEllers.h"
+#include "../MazeGrid.h"
+#include "MazeGenerationScratch.h"
+
+RandomEllers::RandomEllers(FMazeGrid& mazeGrid, int32 seed, FMazeGenerationScratch& scratch)
+	:MazeGrid(mazeGrid)
+	, Seed(seed)
+	, EllersRow(scratch.EllersRow)
+	, EastWalls(scratch.EastWalls)
+	, SouthWalls(scratch.SouthWalls)
+{
+
+}
+
+RandomEllers::~RandomEllers()
+{
+}
+
+void RandomEllers::DoWork()
+{
+	//Every row is written as a whole, the visited cells aren't used
+	MazeGrid.ResetWalls();
+
+	Ellers();
+}
+
+void RandomEllers::Ellers()
+{
+	if (MazeGrid.GetNrOfCells() == 0)
+		return;
+
+	EllersRow.Init(MazeGrid.NrOfMazeColumns, Seed);
+
+	const int nrOfWordsPerRow = EllersRow.GetNrOfWordsPerRow();
+	for (int row = 0; row < MazeGrid.NrOfMazeRows; row++)
+	{
+		EllersRow.GenerateRow(row + 1 == MazeGrid.NrOfMazeRows, EastWalls, SouthWalls);
+
+		//A row of walls has the same layout in the grid
+		const int eastWordIdx = MazeGrid.GetWallIndex(row, 0, FMazeGrid::East) >> 6;
+		const int southWordIdx = MazeGrid.GetWallIndex(row, 0, FMazeGrid::South) >> 6;
+		FMemory::Memcpy(&MazeGrid.Walls[eastWordIdx], EastWalls.GetData(), nrOfWordsPerRow * sizeof(uint64));
+		FMemory::Memcpy(&MazeGrid.Walls[southWordIdx], SouthWalls.GetData(), nrOfWordsPerRow * sizeof(uint64));
+	}
+}
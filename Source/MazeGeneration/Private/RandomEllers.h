@@ -0,0 +1,35 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FMazeGrid;
+struct FMazeGenerationScratch;
+struct FMazeEllersRow;
+
+class RandomEllers : public FNonAbandonableTask
+{
+public:
+	RandomEllers(FMazeGrid& mazeGrid, int32 seed, FMazeGenerationScratch& scratch);
+	~RandomEllers();
+
+	void DoWork();
+
+	FORCEINLINE TStatId GetStatId() const
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(RandomEllers, STATGROUP_ThreadPoolAsyncTasks)
+	}
+
+private:
+	void Ellers();
+
+	FMazeGrid& MazeGrid;
+	int32 Seed;
+
+	//Kept between mazes, the walls of the row that was carved last
+	FMazeEllersRow& EllersRow;
+	TArray<uint64>& EastWalls;
+	TArray<uint64>& SouthWalls;
+
+};
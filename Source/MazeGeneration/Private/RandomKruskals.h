@@ -3,43 +3,30 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "MazeDisjointSet.h"
 
-struct FMazeNode;
-struct FMazeNodeConnection;
+struct FMazeGrid;
+struct FMazeGenerationScratch;
 
-struct FNodeTree
+class RandomKruskals : public FNonAbandonableTask
 {
-	FMazeNode* MazeNode;
-	
+public:
+	RandomKruskals(FMazeGrid& mazeGrid, int32 seed, FMazeGenerationScratch& scratch);
+	~RandomKruskals();
 
+	void DoWork();
 
-	FNodeTree()
-		:MazeNode(nullptr)
-		
+	FORCEINLINE TStatId GetStatId() const
 	{
-
+		RETURN_QUICK_DECLARE_CYCLE_STAT(RandomKruskals, STATGROUP_ThreadPoolAsyncTasks)
 	}
 
-};
-
-
-class RandomKruskals
-{
-public:
-	RandomKruskals(FVector mazeStartPosition, int nrOfMazeColumns, int nrOfMazeRows, float MazeTileSize, TArray<FMazeNode*>& arrayOfNodes, TArray<FMazeNodeConnection*>& arrayOfWalls);
-	~RandomKruskals();
-	void Kruskals(TArray<FMazeNodeConnection*> copyArrayOfWalls);
-	void CreateMazeNodes(TArray<FMazeNode*>& arrayOfNodes, TArray<FMazeNodeConnection*>& arrayOfWalls);
-	bool IsNotUniqueConnection(TArray<FMazeNodeConnection*>& arrayOfWalls, int nodeIdx,int adjacentIdx) const;
-
 private:
-	FVector MazeStartPosition;
-	int NrOfMazeColumns;
-	int NrOfMazeRows;
-	float MazeTileSize;
-	TMap<int, FNodeTree*> NodeTreeMap;
-	TMap<int, int*> RootIdMap;
-	TArray<TSet<int>> ConnectedNodes;
-	
+	FMazeGrid& MazeGrid;
+	FRandomStream RandomStream;
+
+	//Kept between mazes
+	TArray<int>& ArrayOfWalls;
+	FMazeDisjointSet& CellSets;
 
 };
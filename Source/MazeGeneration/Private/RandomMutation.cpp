@@ -0,0 +1,182 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RandomMutation.h"
+#include "../MazeGrid.h"
+#include "MazeGenerationScratch.h"
+#include "Algo/Reverse.h"
+
+RandomMutation::RandomMutation(FMazeGrid& mazeGrid, TArrayView<const int32> seeds, int nrOfMoves, FMazeGenerationScratch& scratch)
+	:MazeGrid(mazeGrid)
+	, Seeds(seeds)
+	, NrOfMoves(nrOfMoves)
+	, VisitStamps(scratch.VisitStamps)
+	, VisitStamp(scratch.VisitStamp)
+	, Parents(scratch.Parents)
+	, CellQueue(scratch.CellQueue)
+	, Path(scratch.Path)
+{
+
+}
+
+RandomMutation::~RandomMutation()
+{
+}
+
+void RandomMutation::DoWork()
+{
+	NrOfMovesDone = 0;
+	const int nrOfCells = MazeGrid.GetNrOfCells();
+	if (nrOfCells < 2 || Seeds.Num() == 0)
+		return;
+
+	//Only sized for a new maze size, the stamps mark the visited cells of a search without clearing them
+	if (VisitStamps.Num() != nrOfCells)
+	{
+		VisitStamps.Init(0, nrOfCells);
+		Parents.SetNumUninitialized(nrOfCells, false);
+		VisitStamp = 0;
+	}
+
+	//The moves keep the tree rooted, so every epoch after the first one only costs its cycles
+	RootTree();
+
+	int fromCellIdx{}, toCellIdx{};
+	for (int32 seed : Seeds)
+	{
+		FRandomStream randomStream(seed);
+		NrOfMovesDone = 0;
+		for (int tryIdx = 0; NrOfMovesDone < NrOfMoves && tryIdx < NrOfMoves * MaxNrOfTriesPerMove; tryIdx++)
+		{
+			//The walls of a perfect maze are the edges that aren't in its spanning tree, border and padding bits are never set
+			const int cellIdx = randomStream.RandRange(0, nrOfCells - 1);
+			const int wallIdx = MazeGrid.GetWallIndex(cellIdx, randomStream.RandRange(0, 1) ? FMazeGrid::South : FMazeGrid::East);
+			if (!MazeGrid.IsWall(wallIdx) || !MazeGrid.GetWallCells(wallIdx, fromCellIdx, toCellIdx))
+				continue;
+
+			//Opening the wall makes a cycle with the path between its cells, closing any wall on that path makes it a tree again
+			FindPath(fromCellIdx, toCellIdx);
+			MoveWall(wallIdx, fromCellIdx, toCellIdx, randomStream.RandRange(0, Path.Num() - 2));
+			NrOfMovesDone++;
+		}
+	}
+}
+
+void RandomMutation::RootTree()
+{
+	//A breadth-first search over the open walls, the first cell is the root and its own parent
+	const uint32 visitStamp = GetNextVisitStamp();
+	CellQueue.Reset();
+	CellQueue.Add(0);
+	VisitStamps[0] = visitStamp;
+	Parents[0] = 0;
+
+	int adjacentCells[4]{}, adjacentWalls[4]{};
+	for (int head = 0; head < CellQueue.Num(); head++)
+	{
+		const int cellIdx = CellQueue[head];
+		const int nrOfAdjacentCells = MazeGrid.GetNeighbors(cellIdx, adjacentCells, adjacentWalls);
+		for (int i = 0; i < nrOfAdjacentCells; i++)
+		{
+			const int adjacentCellIdx = adjacentCells[i];
+			if (MazeGrid.IsWall(adjacentWalls[i]) || VisitStamps[adjacentCellIdx] == visitStamp)
+				continue;
+
+			VisitStamps[adjacentCellIdx] = visitStamp;
+			Parents[adjacentCellIdx] = cellIdx;
+			CellQueue.Add(adjacentCellIdx);
+		}
+	}
+}
+
+void RandomMutation::FindPath(int fromCellIdx, int toCellIdx)
+{
+	//Both cells walk up the tree in turns, the first cell one of them reaches that the other one passed already is their lowest common ancestor
+	const uint32 fromStamp = GetNextVisitStamp();
+	const uint32 toStamp = GetNextVisitStamp();
+	VisitStamps[fromCellIdx] = fromStamp;
+	VisitStamps[toCellIdx] = toStamp;
+
+	int fromTopIdx = fromCellIdx, toTopIdx = toCellIdx;
+	int ancestorIdx = INDEX_NONE;
+	while (ancestorIdx == INDEX_NONE)
+	{
+		if (Parents[fromTopIdx] != fromTopIdx)
+		{
+			fromTopIdx = Parents[fromTopIdx];
+			if (VisitStamps[fromTopIdx] == toStamp)
+				ancestorIdx = fromTopIdx;
+			VisitStamps[fromTopIdx] = fromStamp;
+		}
+		if (ancestorIdx == INDEX_NONE && Parents[toTopIdx] != toTopIdx)
+		{
+			toTopIdx = Parents[toTopIdx];
+			if (VisitStamps[toTopIdx] == fromStamp)
+				ancestorIdx = toTopIdx;
+			VisitStamps[toTopIdx] = toStamp;
+		}
+	}
+
+	//The path runs from the first cell to the second, which is the same path whatever cell the tree is rooted at
+	Path.Reset();
+	for (int pathCellIdx = fromCellIdx; pathCellIdx != ancestorIdx; pathCellIdx = Parents[pathCellIdx])
+	{
+		Path.Add(pathCellIdx);
+	}
+	Path.Add(ancestorIdx);
+	const int nrOfFromCells = Path.Num();
+	for (int pathCellIdx = toCellIdx; pathCellIdx != ancestorIdx; pathCellIdx = Parents[pathCellIdx])
+	{
+		Path.Add(pathCellIdx);
+	}
+	Algo::Reverse(Path.GetData() + nrOfFromCells, Path.Num() - nrOfFromCells);
+}
+
+void RandomMutation::MoveWall(int openedWallIdx, int fromCellIdx, int toCellIdx, int pathIdx)
+{
+	const int cellIdx = Path[pathIdx];
+	const int nextCellIdx = Path[pathIdx + 1];
+	MazeGrid.RemoveWall(openedWallIdx);
+	MazeGrid.SetWall(GetWallBetween(cellIdx, nextCellIdx));
+
+	//Closing the wall cuts off the subtree below it, that subtree holds one of the cells of the opened wall and now hangs from the other one
+	const bool isFromCut = Parents[cellIdx] == nextCellIdx;
+	const int cutRootIdx = isFromCut ? cellIdx : nextCellIdx;
+	int pathCellIdx = isFromCut ? fromCellIdx : toCellIdx;
+	int newParentIdx = isFromCut ? toCellIdx : fromCellIdx;
+
+	//Only the parents on the way up to the cut are turned around
+	while (true)
+	{
+		const int oldParentIdx = Parents[pathCellIdx];
+		Parents[pathCellIdx] = newParentIdx;
+		if (pathCellIdx == cutRootIdx)
+			break;
+		newParentIdx = pathCellIdx;
+		pathCellIdx = oldParentIdx;
+	}
+}
+
+int RandomMutation::GetWallBetween(int fromCellIdx, int toCellIdx) const
+{
+	int adjacentCells[4]{}, adjacentWalls[4]{};
+	const int nrOfAdjacentCells = MazeGrid.GetNeighbors(fromCellIdx, adjacentCells, adjacentWalls);
+	for (int i = 0; i < nrOfAdjacentCells; i++)
+	{
+		if (adjacentCells[i] == toCellIdx)
+			return adjacentWalls[i];
+	}
+
+	checkNoEntry();
+	return INDEX_NONE;
+}
+
+uint32 RandomMutation::GetNextVisitStamp()
+{
+	if (++VisitStamp == 0)
+	{
+		VisitStamps.Init(0, VisitStamps.Num());
+		VisitStamp = 1;
+	}
+	return VisitStamp;
+}
@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FMazeGrid;
+struct FMazeGenerationScratch;
+
+/**
+ * Changes a perfect maze a little instead of generating a new one.
+ * A move opens a random wall and closes a random other wall on the cycle that made, so the maze stays perfect.
+ * The maze is rooted as a tree once, after that a move only costs the length of its cycle, no matter how big the maze is.
+ */
+class RandomMutation : public FNonAbandonableTask
+{
+public:
+	/*Every seed is one epoch of moves, the epochs are applied in order.*/
+	RandomMutation(FMazeGrid& mazeGrid, TArrayView<const int32> seeds, int nrOfMoves, FMazeGenerationScratch& scratch);
+	~RandomMutation();
+
+	void DoWork();
+
+	/*The moves the last epoch made, only fewer than asked when no wall was found to open.*/
+	FORCEINLINE int GetNrOfMovesDone() const { return NrOfMovesDone; }
+
+	FORCEINLINE TStatId GetStatId() const
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(RandomMutation, STATGROUP_ThreadPoolAsyncTasks)
+	}
+
+	//Every other inner wall of a perfect maze is closed, so running out of tries is very unlikely unless the maze has no walls at all
+	static constexpr int MaxNrOfTriesPerMove = 64;
+
+private:
+	void RootTree();
+	void FindPath(int fromCellIdx, int toCellIdx);
+	void MoveWall(int openedWallIdx, int fromCellIdx, int toCellIdx, int pathIdx);
+	int GetWallBetween(int fromCellIdx, int toCellIdx) const;
+	uint32 GetNextVisitStamp();
+
+	FMazeGrid& MazeGrid;
+	TArrayView<const int32> Seeds;
+	int NrOfMoves;
+	int NrOfMovesDone = 0;
+
+	//Kept between mazes
+	TArray<uint32>& VisitStamps;
+	uint32& VisitStamp;
+	TArray<int>& Parents;
+	TArray<int>& CellQueue;
+	TArray<int>& Path;
+
+};
@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RandomPrims.h"
+#include "../MazeGrid.h"
+#include "MazeGenerationScratch.h"
+
+RandomPrims::RandomPrims(FMazeGrid& mazeGrid, int32 seed, FMazeGenerationScratch& scratch)
+	:MazeGrid(mazeGrid)
+	, RandomStream(seed)
+	, Frontier(scratch.Frontier)
+	, InFrontier(scratch.InFrontier)
+{
+
+}
+
+RandomPrims::~RandomPrims()
+{
+}
+
+void RandomPrims::DoWork()
+{
+	MazeGrid.ResetWalls();
+	MazeGrid.ResetVisited();
+
+	Prims();
+}
+
+void RandomPrims::Prims()
+{
+	const int nrOfCells = MazeGrid.GetNrOfCells();
+	if (nrOfCells == 0)
+		return;
+
+	//A cell is in the frontier at most once
+	Frontier.Reset(nrOfCells);
+	InFrontier.Init(false, nrOfCells);
+
+	int startCellIdx = 0;
+	MazeGrid.SetVisited(startCellIdx);
+	AddToFrontier(startCellIdx);
+
+	int adjacentCells[4]{}, adjacentWalls[4]{};
+	int visitedWalls[4]{};
+	int nrOfVisitedWalls{};
+
+	while (Frontier.Num() > 0)
+	{
+		//Take a random cell out of the frontier
+		const int randIdx = RandomStream.RandRange(0, Frontier.Num() - 1);
+		const int cellIdx = Frontier[randIdx];
+		Frontier.RemoveAtSwap(randIdx, 1, false);
+		InFrontier[cellIdx] = false;
+
+		//Connect it to a random adjacent cell that is already part of the maze
+		const int nrOfAdjacentCells = MazeGrid.GetNeighbors(cellIdx, adjacentCells, adjacentWalls);
+		nrOfVisitedWalls = 0;
+		for (int i = 0; i < nrOfAdjacentCells; i++)
+		{
+			if (MazeGrid.IsVisited(adjacentCells[i]))
+				visitedWalls[nrOfVisitedWalls++] = adjacentWalls[i];
+		}
+		MazeGrid.RemoveWall(visitedWalls[RandomStream.RandRange(0, nrOfVisitedWalls - 1)]);
+
+		MazeGrid.SetVisited(cellIdx);
+		AddToFrontier(cellIdx);
+	}
+}
+
+void RandomPrims::AddToFrontier(int cellIdx)
+{
+	//Add the adjacent cells that are not part of the maze and not in the frontier yet
+	int adjacentCells[4]{}, adjacentWalls[4]{};
+	const int nrOfAdjacentCells = MazeGrid.GetNeighbors(cellIdx, adjacentCells, adjacentWalls);
+	for (int i = 0; i < nrOfAdjacentCells; i++)
+	{
+		const int adjacentCellIdx = adjacentCells[i];
+		if (!MazeGrid.IsVisited(adjacentCellIdx) && !InFrontier[adjacentCellIdx])
+		{
+			InFrontier[adjacentCellIdx] = true;
+			Frontier.Add(adjacentCellIdx);
+		}
+	}
+}
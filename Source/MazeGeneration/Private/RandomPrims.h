@@ -0,0 +1,34 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FMazeGrid;
+struct FMazeGenerationScratch;
+
+class RandomPrims : public FNonAbandonableTask
+{
+public:
+	RandomPrims(FMazeGrid& mazeGrid, int32 seed, FMazeGenerationScratch& scratch);
+	~RandomPrims();
+
+	void DoWork();
+
+	FORCEINLINE TStatId GetStatId() const
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(RandomPrims, STATGROUP_ThreadPoolAsyncTasks)
+	}
+
+private:
+	void Prims();
+	void AddToFrontier(int cellIdx);
+
+	FMazeGrid& MazeGrid;
+	FRandomStream RandomStream;
+
+	//Cells next to the maze that are not part of it yet, removing a random cell is a swap and pop. Kept between mazes
+	TArray<int>& Frontier;
+	TBitArray<>& InFrontier;
+
+};
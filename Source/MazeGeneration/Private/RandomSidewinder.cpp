@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RandomSidewinder.h"
+#include "../MazeGrid.h"
+#include "MazeRowWords.h"
+
+RandomSidewinder::RandomSidewinder(FMazeGrid& mazeGrid, int32 seed)
+	:MazeGrid(mazeGrid)
+	, Seed(seed)
+{
+
+}
+
+RandomSidewinder::~RandomSidewinder()
+{
+}
+
+void RandomSidewinder::DoWork()
+{
+	//Every word of every row is written, so the walls aren't reset first and the visited cells aren't used
+	FMazeRowWords::ForEachRowParallel(MazeGrid, [this](int row, uint64* eastWalls, uint64* southWalls)
+	{
+		CarveRow(row, eastWalls, southWalls);
+	});
+}
+
+void RandomSidewinder::CarveRow(int row, uint64* eastWalls, uint64* southWalls) const
+{
+	const int nrOfWordsPerRow = MazeGrid.NrOfWordsPerRow;
+
+	//The last row is one corridor to the east, every run above ends up in it
+	if (row + 1 == MazeGrid.NrOfMazeRows)
+	{
+		FMemory::Memzero(eastWalls, nrOfWordsPerRow * sizeof(uint64));
+		FMemory::Memzero(southWalls, nrOfWordsPerRow * sizeof(uint64));
+		return;
+	}
+
+	//Set if bit 0 of the next word starts a run that still has to carve south
+	uint64 isRunPending = 1;
+	for (int wordIdx = 0; wordIdx < nrOfWordsPerRow; wordIdx++)
+	{
+		const uint64 colMask = FMazeRowWords::GetColumnMask(MazeGrid, wordIdx);
+		const uint64 eastMask = FMazeRowWords::GetEastMask(MazeGrid, wordIdx);
+
+		//A run ends at every cell that doesn't carve east, the last column always ends one
+		const uint64 isCarvedEast = FMazeRowWords::GetRandomWord(Seed, row, wordIdx * 2) & eastMask;
+		const uint64 isRunEnd = colMask & ~isCarvedEast;
+		const uint64 isRunStart = ((isRunEnd << 1) | isRunPending) & colMask;
+
+		//A run carves south from the first cell a coin flip picks, or from its last cell if none is picked.
+		//Subtracting the starts borrows up to the first picked cell of every run, which leaves only that cell
+		const uint64 isPicked = (FMazeRowWords::GetRandomWord(Seed, row, wordIdx * 2 + 1) & colMask) | isRunEnd;
+		const uint64 isCarvedSouth = isPicked & ~(isPicked - isRunStart);
+
+		eastWalls[wordIdx] = isRunEnd & eastMask;
+		southWalls[wordIdx] = colMask & ~isCarvedSouth;
+
+		//The last run of the word carries over if it hasn't picked a cell yet, or a new run starts with the next word
+		const bool isLastRunOpen = isRunStart && !(isPicked >> (63 - FMath::CountLeadingZeros64(isRunStart)));
+		isRunPending = (isRunEnd >> 63) | (isLastRunOpen ? 1 : 0);
+	}
+}
@@ -0,0 +1,32 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FMazeGrid;
+
+/**
+ * Sidewinder, every row is split in runs of cells joined to the east and every run carves south once.
+ * Runs never cross rows, so a row is carved 64 cells at a time and the rows on all cores.
+ */
+class RandomSidewinder : public FNonAbandonableTask
+{
+public:
+	RandomSidewinder(FMazeGrid& mazeGrid, int32 seed);
+	~RandomSidewinder();
+
+	void DoWork();
+
+	FORCEINLINE TStatId GetStatId() const
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(RandomSidewinder, STATGROUP_ThreadPoolAsyncTasks)
+	}
+
+private:
+	void CarveRow(int row, uint64* eastWalls, uint64* southWalls) const;
+
+	FMazeGrid& MazeGrid;
+	int32 Seed;
+
+};
@@ -0,0 +1,143 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TiledMazeGenerator.h"
+#include "../MazeGenerator.h"
+#include "MazeDisjointSet.h"
+#include "MazeGenerationScratch.h"
+#include "../MazeGrid.h"
+#include "Async/ParallelFor.h"
+#include "../MazeGeneration.h"
+
+TiledMazeGenerator::TiledMazeGenerator(const FMazeGenerationSettings& settings, FMazeGrid& mazeGrid, FMazeGenerationScratch& scratch)
+	:Settings(settings)
+	, MazeGrid(mazeGrid)
+	, Scratch(scratch)
+	, TileSize(GetTileSize(settings))
+	, NrOfTileColumns(FMath::DivideAndRoundUp(mazeGrid.NrOfMazeColumns, TileSize))
+	, NrOfTileRows(FMath::DivideAndRoundUp(mazeGrid.NrOfMazeRows, TileSize))
+{
+
+}
+
+TiledMazeGenerator::~TiledMazeGenerator()
+{
+}
+
+bool TiledMazeGenerator::IsTiled(const FMazeGenerationSettings& settings, const FMazeGrid& mazeGrid)
+{
+	//These carve every row on all cores already, tiles would only add stitching
+	if (settings.Algorithm == EMazeAlgorithm::RANDOMBINARYTREE || settings.Algorithm == EMazeAlgorithm::RANDOMSIDEWINDER)
+		return false;
+
+	const int tileSize = GetTileSize(settings);
+	return tileSize > 0 && (mazeGrid.NrOfMazeColumns > tileSize || mazeGrid.NrOfMazeRows > tileSize);
+}
+
+int TiledMazeGenerator::GetTileSize(const FMazeGenerationSettings& settings)
+{
+	return settings.ParallelTileSize > 0 ? FMath::DivideAndRoundUp(settings.ParallelTileSize, 64) * 64 : 0;
+}
+
+void TiledMazeGenerator::DoWork()
+{
+	MazeGrid.ResetVisited();
+
+	//Every tile keeps its grid and scratch for the next maze
+	const int nrOfTiles = NrOfTileColumns * NrOfTileRows;
+	Scratch.TileGrids.SetNum(nrOfTiles);
+	while (Scratch.TileScratches.Num() < nrOfTiles)
+		Scratch.TileScratches.Add(MakeUnique<FMazeGenerationScratch>());
+
+	//Every tile writes its own words of the grid, the tile borders start closed
+	ParallelFor(nrOfTiles, [this](int tileIdx)
+	{
+		GenerateTile(tileIdx);
+	});
+
+	StitchTiles();
+}
+
+void TiledMazeGenerator::GenerateTile(int tileIdx)
+{
+	const FIntRect tileCells = GetTileCells(tileIdx);
+	const int nrOfCols = tileCells.Width();
+	const int nrOfRows = tileCells.Height();
+
+	//Every tile is a perfect maze of its own, generated with a seed of its own
+	FMazeGrid& tileGrid = Scratch.TileGrids[tileIdx];
+	tileGrid.Init(MazeGrid.MazeStartPosition, nrOfCols, nrOfRows, MazeGrid.MazeTileSize);
+	FMazeGenerationSettings tileSettings = Settings;
+	tileSettings.Seed = (int32)HashCombine(GetTypeHash(Settings.Seed), GetTypeHash(tileIdx));
+	tileSettings.ParallelTileSize = 0;
+	FMazeGenerationTask::Generate(tileSettings, tileGrid, *Scratch.TileScratches[tileIdx]);
+
+	//The walls on the east and south border of the tile are closed, unless it is the border of the maze
+	const bool hasEastBorder = tileCells.Max.X < MazeGrid.NrOfMazeColumns;
+	const bool hasSouthBorder = tileCells.Max.Y < MazeGrid.NrOfMazeRows;
+	for (int row = 0; row < nrOfRows; row++)
+	{
+		for (int word = 0; word < tileGrid.NrOfWordsPerRow; word++)
+		{
+			const int firstCol = word * 64;
+			const int nrOfColsInWord = FMath::Min(64, nrOfCols - firstCol);
+			uint64 eastWalls = tileGrid.Walls[tileGrid.GetWallIndex(row, firstCol, FMazeGrid::East) >> 6];
+			uint64 southWalls = tileGrid.Walls[tileGrid.GetWallIndex(row, firstCol, FMazeGrid::South) >> 6];
+
+			if (hasEastBorder && word + 1 == tileGrid.NrOfWordsPerRow)
+				eastWalls |= 1ull << (nrOfColsInWord - 1);
+			if (hasSouthBorder && row + 1 == nrOfRows)
+				southWalls = nrOfColsInWord == 64 ? ~0ull : (1ull << nrOfColsInWord) - 1;
+
+			MazeGrid.Walls[MazeGrid.GetWallIndex(tileCells.Min.Y + row, tileCells.Min.X + firstCol, FMazeGrid::East) >> 6] = eastWalls;
+			MazeGrid.Walls[MazeGrid.GetWallIndex(tileCells.Min.Y + row, tileCells.Min.X + firstCol, FMazeGrid::South) >> 6] = southWalls;
+		}
+	}
+}
+
+void TiledMazeGenerator::StitchTiles()
+{
+	SCOPE_CYCLE_COUNTER(STAT_MazeStitchTiles);
+	TRACE_CPUPROFILER_EVENT_SCOPE(TiledMazeGenerator::StitchTiles);
+
+	//Every tile has a border with the tile to its east and the tile to its south, stored as tileIdx * 2 + wall plane
+	TArray<int>& tileBorders = Scratch.TileBorders;
+	tileBorders.Reset(NrOfTileColumns * NrOfTileRows * FMazeGrid::NrOfWallPlanes);
+	for (int tileIdx = 0; tileIdx < NrOfTileColumns * NrOfTileRows; tileIdx++)
+	{
+		if (tileIdx % NrOfTileColumns + 1 < NrOfTileColumns)
+			tileBorders.Add(tileIdx * FMazeGrid::NrOfWallPlanes + FMazeGrid::East);
+		if (tileIdx / NrOfTileColumns + 1 < NrOfTileRows)
+			tileBorders.Add(tileIdx * FMazeGrid::NrOfWallPlanes + FMazeGrid::South);
+	}
+
+	FRandomStream randomStream(Settings.Seed);
+	for (int i = tileBorders.Num() - 1; i > 0; i--)
+		tileBorders.Swap(i, randomStream.RandRange(0, i));
+
+	//Joining the tiles as a spanning tree opens one wall for every tile but one, so the maze stays a spanning tree
+	FMazeDisjointSet& tileSets = Scratch.TileSets;
+	tileSets.Init(NrOfTileColumns * NrOfTileRows);
+	for (int tileBorder : tileBorders)
+	{
+		const int tileIdx = tileBorder / FMazeGrid::NrOfWallPlanes;
+		const bool isEastBorder = tileBorder % FMazeGrid::NrOfWallPlanes == FMazeGrid::East;
+		if (!tileSets.Union(tileIdx, isEastBorder ? tileIdx + 1 : tileIdx + NrOfTileColumns))
+			continue;
+
+		//Open a random wall along the border
+		const FIntRect tileCells = GetTileCells(tileIdx);
+		if (isEastBorder)
+			MazeGrid.RemoveWall(MazeGrid.GetWallIndex(randomStream.RandRange(tileCells.Min.Y, tileCells.Max.Y - 1), tileCells.Max.X - 1, FMazeGrid::East));
+		else
+			MazeGrid.RemoveWall(MazeGrid.GetWallIndex(tileCells.Max.Y - 1, randomStream.RandRange(tileCells.Min.X, tileCells.Max.X - 1), FMazeGrid::South));
+	}
+}
+
+FIntRect TiledMazeGenerator::GetTileCells(int tileIdx) const
+{
+	const int firstCol = (tileIdx % NrOfTileColumns) * TileSize;
+	const int firstRow = (tileIdx / NrOfTileColumns) * TileSize;
+	return FIntRect(firstCol, firstRow,
+		FMath::Min(firstCol + TileSize, MazeGrid.NrOfMazeColumns), FMath::Min(firstRow + TileSize, MazeGrid.NrOfMazeRows));
+}
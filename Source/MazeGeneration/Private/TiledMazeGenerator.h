@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MazeGenerationTask.h"
+
+struct FMazeGrid;
+struct FMazeGenerationScratch;
+
+/**
+ * Splits the maze in square tiles, generates a perfect maze in every tile on all cores and stitches the tiles together.
+ * The tiles are a multiple of 64 cells wide, so no two tiles write the same word of walls.
+ */
+class TiledMazeGenerator : public FNonAbandonableTask
+{
+public:
+	TiledMazeGenerator(const FMazeGenerationSettings& settings, FMazeGrid& mazeGrid, FMazeGenerationScratch& scratch);
+	~TiledMazeGenerator();
+
+	void DoWork();
+
+	/*If the maze is bigger than one tile of the settings.*/
+	static bool IsTiled(const FMazeGenerationSettings& settings, const FMazeGrid& mazeGrid);
+	/*The parallel tile size rounded up to whole words of walls.*/
+	static int GetTileSize(const FMazeGenerationSettings& settings);
+
+	FORCEINLINE TStatId GetStatId() const
+	{
+		RETURN_QUICK_DECLARE_CYCLE_STAT(TiledMazeGenerator, STATGROUP_ThreadPoolAsyncTasks)
+	}
+
+private:
+	void GenerateTile(int tileIdx);
+	void StitchTiles();
+	FIntRect GetTileCells(int tileIdx) const;
+
+	FMazeGenerationSettings Settings;
+	FMazeGrid& MazeGrid;
+	FMazeGenerationScratch& Scratch;
+	int TileSize;
+	int NrOfTileColumns;
+	int NrOfTileRows;
+
+};
@@ -7,12 +7,12 @@
 /**
  * 
  */
-struct FMazeNode;
-struct FMazeNodeConnection;
+struct FMazeGrid;
+struct FMazeGenerationScratch;
 class MAZEGENERATION_API RandomDepthFirstSearch: public FNonAbandonableTask
 {
 public:
-	RandomDepthFirstSearch(FVector mazeStartPosition, int nrOfMazeColumns, int nrOfMazeRows, float MazeTileSize, TArray<FMazeNode*>& arrayOfNodes, TArray<FMazeNodeConnection*>& arrayOfWalls);
+	RandomDepthFirstSearch(FMazeGrid& mazeGrid, int32 seed, FMazeGenerationScratch& scratch);
 	~RandomDepthFirstSearch();
 
 	void DoWork();
@@ -23,18 +23,12 @@ public:
 	}
 
 private:
-	void CreateMazeGrid(TArray<FMazeNodeConnection*>& arrayOfWalls);
 	void CarvePath();
-	void RandomDFS(FMazeNode* node, TArray<FMazeNode*>& nodePath);
 
-	FVector MazeStartPosition;
-	int NrOfMazeColumns;
-	int NrOfMazeRows;
-	float MazeTileSize;
-	TMap<int, FMazeNode*> MazeNodeGrid;
-	TArray<FMazeNode*> MazeNodePath;
+	FMazeGrid& MazeGrid;
+	FRandomStream RandomStream;
 
-	TArray<FMazeNodeConnection*>& ArrayOfWalls;
-	TArray<FMazeNode*>& ArrayOfNodes;
+	//Kept between mazes, every cell is pushed at most once
+	TArray<int>& CellStack;
 
 };